@@ -0,0 +1,161 @@
+// -----------------------------------------------------------------------------
+// libDDG -- bench/gemm.cpp
+// -----------------------------------------------------------------------------
+//
+// Times dense matrix-vector products at the shapes used by the applications:
+// an n x k matrix (n up to 10M, k up to 64) times a k x 1 vector.  For each
+// shape and scalar type the benchmark reports the time of DenseMatrix::operator*
+// (which dispatches to BLAS for Real and Complex, and to the blocked kernel for
+// Quaternion), of the in-library blocked kernel gemm(), and of the row-by-row
+// loop that operator* used to run, along with the largest relative difference
+// between the results.  Build and run it with
+//
+//    make bench
+//    ./bench/gemm [maxEntries]
+//
+// Matrices that take more memory than maxEntries doubles (default 2^26, i.e.,
+// 512MB) are skipped; pass 640000000 to run the full 10M x 64 real case.
+//
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+using namespace std;
+
+#include "DenseMatrix.h"
+#include "Real.h"
+#include "Complex.h"
+#include "Quaternion.h"
+#include "Utility.h"
+using namespace DDG;
+
+const int nTrials = 3;
+// each time is the best of this many runs
+
+double difference( const Real& a, const Real& b ) { return fabs( a - b ); }
+double difference( const Complex& a, const Complex& b ) { return ( a - b ).norm(); }
+double difference( const Quaternion& a, const Quaternion& b ) { return ( a - b ).norm(); }
+// returns the distance between two scalars
+
+template <class T>
+void naiveProduct( const DenseMatrix<T>& A, const DenseMatrix<T>& x, DenseMatrix<T>& y )
+// computes y = Ax one row at a time, as the original operator* did
+{
+   for( int i = 0; i < A.nRows(); i++ )
+   {
+      T sum = 0.;
+      for( int k = 0; k < A.nColumns(); k++ )
+      {
+         sum += A( i, k ) * x( k );
+      }
+      y( i ) = sum;
+   }
+}
+
+template <class T>
+void blockedProduct( DenseMatrix<T>& A, DenseMatrix<T>& x, DenseMatrix<T>& y )
+// computes y = Ax using the in-library blocked kernel
+{
+   y.zero();
+   gemm<T>( A.nRows(), 1, A.nColumns(), &A( 0, 0 ), &x( 0 ), &y( 0 ));
+}
+
+template <>
+void blockedProduct( DenseMatrix<Real>& A, DenseMatrix<Real>& x, DenseMatrix<Real>& y )
+// same as above; Real runs the kernel on plain doubles, as gemm() does for
+// products too small for BLAS
+{
+   y.zero();
+   gemm<double>( A.nRows(), 1, A.nColumns(),
+                 (const double*) &A( 0, 0 ),
+                 (const double*) &x( 0 ),
+                 (double*) &y( 0 ));
+}
+
+template <class T>
+double maxDifference( const DenseMatrix<T>& y, const DenseMatrix<T>& z )
+// returns the largest distance between corresponding entries of y and z,
+// relative to the largest entry of z
+{
+   double d = 0., s = 0.;
+   for( int i = 0; i < y.nRows(); i++ )
+   {
+      d = max( d, difference( y( i ), z( i )));
+      s = max( s, difference( z( i ), T( 0. )));
+   }
+   return d / max( s, 1e-300 );
+}
+
+template <class T>
+void benchmark( const char* name, int n, int k, double maxEntries )
+// times the product of a random n x k matrix and a random k-vector, unless
+// the matrix takes more memory than maxEntries doubles
+{
+   double size = (double) n * (double) k * (double)( sizeof( T ) / sizeof( double ));
+   if( size > maxEntries )
+   {
+      cout << setw( 10 ) << name
+           << setw( 10 ) << n
+           << setw( 4 ) << k
+           << "  skipped (" << size << " doubles > maxEntries)" << endl;
+      return;
+   }
+
+   DenseMatrix<T> A( n, k ), x( k ), y( n ), z( n ), w( n );
+   A.randomize();
+   x.randomize();
+
+   double t0 = wallClock();
+   naiveProduct( A, x, z );
+   double tNaive = wallClock() - t0;
+
+   double tOperator = 1e300, tBlocked = 1e300;
+   for( int trial = 0; trial < nTrials; trial++ )
+   {
+      t0 = wallClock();
+      y = A * x;
+      tOperator = min( tOperator, wallClock() - t0 );
+
+      t0 = wallClock();
+      blockedProduct( A, x, w );
+      tBlocked = min( tBlocked, wallClock() - t0 );
+   }
+
+   cout << setw( 10 ) << name
+        << setw( 10 ) << n
+        << setw( 4 ) << k
+        << setw( 12 ) << 1e3 * tOperator
+        << setw( 12 ) << 1e3 * tBlocked
+        << setw( 12 ) << 1e3 * tNaive
+        << setw( 12 ) << max( maxDifference( y, z ), maxDifference( w, z )) << endl;
+}
+
+int main( int argc, char** argv )
+{
+   double maxEntries = 67108864.;
+   if( argc > 1 ) maxEntries = atof( argv[1] );
+
+   const int nRows[] = { 10000, 100000, 1000000, 10000000 };
+   const int nColumns[] = { 1, 4, 16, 64 };
+
+   cout << setprecision( 3 );
+   cout << setw( 10 ) << "type"
+        << setw( 10 ) << "n"
+        << setw( 4 ) << "k"
+        << setw( 12 ) << "A*x (ms)"
+        << setw( 12 ) << "gemm (ms)"
+        << setw( 12 ) << "naive (ms)"
+        << setw( 12 ) << "rel. error" << endl;
+
+   for( int i = 0; i < 4; i++ )
+   for( int j = 0; j < 4; j++ )
+   {
+      benchmark<Real>( "Real", nRows[i], nColumns[j], maxEntries );
+      benchmark<Complex>( "Complex", nRows[i], nColumns[j], maxEntries );
+      benchmark<Quaternion>( "Quaternion", nRows[i], nColumns[j], maxEntries );
+   }
+
+   return 0;
+}
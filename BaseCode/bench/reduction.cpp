@@ -0,0 +1,295 @@
+// -----------------------------------------------------------------------------
+// libDDG -- bench/reduction.cpp
+// -----------------------------------------------------------------------------
+//
+// Checks and times the reduction kernels in Reduction.h.  For each kernel the
+// benchmark reports
+//
+//    - the largest error, over a range of array lengths, relative to the same
+//      reduction carried out in long double (and, for comparison, the error
+//      of a plain loop in double),
+//    - whether the result is bitwise identical for 1, 2, 3, 8, and the
+//      default number of threads, and
+//    - the time per call on one long array, for a plain loop and for the
+//      kernel with one and with the default number of threads.
+//
+// Build and run it with
+//
+//    make bench
+//    ./bench/reduction [n]
+//
+// where n is the length of the arrays that are timed (default 2^22).  To look
+// for data races, rebuild everything with ThreadSanitizer:
+//
+//    make clean
+//    make bench SANITIZE=-fsanitize=thread
+//
+// The program exits with a nonzero status if some kernel is not
+// deterministic or its error exceeds the usual n*epsilon bound.
+//
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+using namespace std;
+
+#include "Reduction.h"
+#include "Utility.h"
+using namespace DDG;
+
+enum Kernel
+{
+   sumKernel,
+   sumAbsKernel,
+   maxAbsKernel,
+   sumSquaresKernel,
+   dotKernel,
+   weightedDotKernel,
+   complexSumKernel,
+   complexSumAbsKernel,
+   complexMaxAbsKernel,
+   complexDotKernel,
+   complexWeightedDotKernel,
+   nKernels
+};
+
+const char* kernelNames[ nKernels ] =
+{
+   "sum",
+   "sumAbs",
+   "maxAbs",
+   "sumSquares",
+   "dot",
+   "weighted dot",
+   "complexSum",
+   "complexSumAbs",
+   "complexMaxAbs",
+   "complexDot",
+   "complex weighted dot"
+};
+
+void reduce( int kernel, const double* x, const double* w, const double* y, long n, int nThreads, double r[2] )
+// stores the result of kernel, computed by Reduction, in r[0] (and r[1] for
+// complex results); complex kernels treat x, w, and y as n complex numbers
+{
+   r[0] = r[1] = 0.;
+
+   switch( kernel )
+   {
+      case sumKernel:                r[0] = Reduction::sum( x, n, nThreads ); break;
+      case sumAbsKernel:             r[0] = Reduction::sumAbs( x, n, nThreads ); break;
+      case maxAbsKernel:             r[0] = Reduction::maxAbs( x, n, nThreads ); break;
+      case sumSquaresKernel:         r[0] = Reduction::sumSquares( x, n, nThreads ); break;
+      case dotKernel:                r[0] = Reduction::dot( x, y, n, nThreads ); break;
+      case weightedDotKernel:        r[0] = Reduction::dot( x, w, y, n, nThreads ); break;
+      case complexSumKernel:         Reduction::complexSum( x, n, r[0], r[1], nThreads ); break;
+      case complexSumAbsKernel:      r[0] = Reduction::complexSumAbs( x, n, nThreads ); break;
+      case complexMaxAbsKernel:      r[0] = Reduction::complexMaxAbs( x, n, nThreads ); break;
+      case complexDotKernel:         Reduction::complexDot( x, y, n, r[0], r[1], nThreads ); break;
+      case complexWeightedDotKernel: Reduction::complexDot( x, w, y, n, r[0], r[1], nThreads ); break;
+   }
+}
+
+template <class S>
+void loop( int kernel, const double* x, const double* w, const double* y, long n, double r[2], double& magnitude )
+// same as above, but computed by a plain loop with accumulators of type S;
+// also stores in magnitude the sum (or maximum) of the absolute values of
+// the terms, which bounds the error of any summation order
+{
+   S s0 = 0., s1 = 0., a = 0.;
+
+   switch( kernel )
+   {
+      case sumKernel:
+         for( long i = 0; i < n; i++ ) { s0 += x[i]; a += fabs( x[i] ); }
+         break;
+      case sumAbsKernel:
+         for( long i = 0; i < n; i++ ) { s0 += fabs( x[i] ); }
+         a = s0;
+         break;
+      case maxAbsKernel:
+         for( long i = 0; i < n; i++ ) { s0 = max( s0, (S) fabs( x[i] )); }
+         a = s0;
+         break;
+      case sumSquaresKernel:
+         for( long i = 0; i < n; i++ ) { s0 += (S) x[i] * x[i]; }
+         a = s0;
+         break;
+      case dotKernel:
+         for( long i = 0; i < n; i++ ) { S t = (S) x[i] * y[i]; s0 += t; a += fabs( t ); }
+         break;
+      case weightedDotKernel:
+         for( long i = 0; i < n; i++ ) { S t = (S) x[i] * w[i] * y[i]; s0 += t; a += fabs( t ); }
+         break;
+      case complexSumKernel:
+         for( long i = 0; i < n; i++ )
+         {
+            s0 += x[2*i+0];
+            s1 += x[2*i+1];
+            a += fabs( x[2*i+0] ) + fabs( x[2*i+1] );
+         }
+         break;
+      case complexSumAbsKernel:
+         for( long i = 0; i < n; i++ ) { s0 += sqrt( (S) x[2*i] * x[2*i] + (S) x[2*i+1] * x[2*i+1] ); }
+         a = s0;
+         break;
+      case complexMaxAbsKernel:
+         for( long i = 0; i < n; i++ ) { s0 = max( s0, sqrt( (S) x[2*i] * x[2*i] + (S) x[2*i+1] * x[2*i+1] )); }
+         a = s0;
+         break;
+      case complexDotKernel:
+         for( long i = 0; i < n; i++ )
+         {
+            // conj(x) y
+            S t0 = (S) x[2*i] * y[2*i]   + (S) x[2*i+1] * y[2*i+1];
+            S t1 = (S) x[2*i] * y[2*i+1] - (S) x[2*i+1] * y[2*i];
+            s0 += t0;
+            s1 += t1;
+            a += fabs( t0 ) + fabs( t1 );
+         }
+         break;
+      case complexWeightedDotKernel:
+         for( long i = 0; i < n; i++ )
+         {
+            // conj(x) w y
+            S pr = (S) x[2*i] * w[2*i]   + (S) x[2*i+1] * w[2*i+1];
+            S pi = (S) x[2*i] * w[2*i+1] - (S) x[2*i+1] * w[2*i];
+            S t0 = pr * y[2*i]   - pi * y[2*i+1];
+            S t1 = pr * y[2*i+1] + pi * y[2*i];
+            s0 += t0;
+            s1 += t1;
+            a += fabs( t0 ) + fabs( t1 );
+         }
+         break;
+   }
+
+   r[0] = s0;
+   r[1] = s1;
+   magnitude = a;
+}
+
+double relativeError( const double r[2], const double reference[2], double magnitude )
+// returns the distance between r and reference, relative to magnitude
+{
+   double e = sqrt( ( r[0]-reference[0] )*( r[0]-reference[0] ) +
+                    ( r[1]-reference[1] )*( r[1]-reference[1] ));
+
+   return magnitude > 0. ? e / magnitude : e;
+}
+
+int main( int argc, char** argv )
+{
+   long nTimed = 4194304;
+   if( argc > 1 ) nTimed = atol( argv[1] );
+
+   const long lengths[] = { 0, 1, 7, 9, 100, 16385, 1048575, 3000001 };
+   const int nLengths = sizeof( lengths ) / sizeof( lengths[0] );
+   const int threadCounts[] = { 1, 2, 3, 8, 0 };
+   const int nThreadCounts = sizeof( threadCounts ) / sizeof( threadCounts[0] );
+   const int nReps = 20;
+
+   // complex kernels read two doubles per entry
+   long nMax = max( nTimed, lengths[ nLengths-1 ] );
+   vector<double> x( 2*nMax ), w( 2*nMax ), y( 2*nMax );
+   srand( 1 );
+   for( long i = 0; i < 2*nMax; i++ )
+   {
+      x[i] = 2.*unitRand() - 1.;
+      w[i] = 2.*unitRand() - 1.;
+      y[i] = 2.*unitRand() - 1.;
+   }
+
+   bool passed = true;
+
+   cout << setprecision( 3 );
+   cout << setw( 22 ) << "kernel"
+        << setw( 12 ) << "error"
+        << setw( 12 ) << "loop error"
+        << setw( 15 ) << "deterministic"
+        << setw( 12 ) << "loop (ms)"
+        << setw( 12 ) << "1 thr (ms)"
+        << setw( 12 ) << "auto (ms)" << endl;
+
+   for( int kernel = 0; kernel < nKernels; kernel++ )
+   {
+      double error = 0., loopError = 0.;
+      bool deterministic = true;
+
+      for( int l = 0; l < nLengths; l++ )
+      {
+         long n = lengths[l];
+         double reference[2], plain[2], r[2], r1[2], magnitude, unused;
+
+         loop<long double>( kernel, &x[0], &w[0], &y[0], n, reference, magnitude );
+         loop<double>( kernel, &x[0], &w[0], &y[0], n, plain, unused );
+
+         for( int t = 0; t < nThreadCounts; t++ )
+         {
+            reduce( kernel, &x[0], &w[0], &y[0], n, threadCounts[t], r );
+
+            if( t == 0 )
+            {
+               memcpy( r1, r, sizeof( r ));
+               error = max( error, relativeError( r, reference, magnitude ));
+               loopError = max( loopError, relativeError( plain, reference, magnitude ));
+               if( relativeError( r, reference, magnitude ) > (double) n * DBL_EPSILON )
+               {
+                  passed = false;
+               }
+            }
+            else if( memcmp( r, r1, sizeof( r )) != 0 )
+            {
+               deterministic = false;
+               passed = false;
+            }
+         }
+      }
+
+      double r[2], magnitude, sink = 0.;
+
+      double t0 = wallClock();
+      for( int rep = 0; rep < nReps; rep++ )
+      {
+         loop<double>( kernel, &x[0], &w[0], &y[0], nTimed, r, magnitude );
+         sink += r[0];
+      }
+      double t1 = wallClock();
+      for( int rep = 0; rep < nReps; rep++ )
+      {
+         reduce( kernel, &x[0], &w[0], &y[0], nTimed, 1, r );
+         sink += r[0];
+      }
+      double t2 = wallClock();
+      for( int rep = 0; rep < nReps; rep++ )
+      {
+         reduce( kernel, &x[0], &w[0], &y[0], nTimed, 0, r );
+         sink += r[0];
+      }
+      double t3 = wallClock();
+
+      cout << setw( 22 ) << kernelNames[ kernel ]
+           << setw( 12 ) << error
+           << setw( 12 ) << loopError
+           << setw( 15 ) << ( deterministic ? "yes" : "NO" )
+           << setw( 12 ) << 1e3 * ( t1 - t0 ) / nReps
+           << setw( 12 ) << 1e3 * ( t2 - t1 ) / nReps
+           << setw( 12 ) << 1e3 * ( t3 - t2 ) / nReps;
+
+      // keep the timed calls from being optimized away
+      if( sink == 1234.5 ) cout << " ";
+      cout << endl;
+   }
+
+   if( !passed )
+   {
+      cerr << "error: some reduction was not deterministic or not accurate" << endl;
+      return 1;
+   }
+
+   return 0;
+}
@@ -0,0 +1,156 @@
+// -----------------------------------------------------------------------------
+// libDDG -- bench/spmv.cpp
+// -----------------------------------------------------------------------------
+//
+// Times the library loops that do their arithmetic directly on Real and
+// Complex entries: the sparse matrix-vector products A*x, multiply( A, x, y ),
+// and SparseOperator::apply, the DenseMatrix updates += and *=, and the
+// DenseMatrix norm and inner product.  A*x and multiply() build the
+// compressed-column copy of A on the first call and reuse it afterward (see
+// SparseMatrix::product()), so their times include one compression spread over
+// the repetitions.  Build and run it with
+//
+//    make bench
+//    ./bench/spmv [n]
+//
+// where n (default 2^18) is the number of rows and columns.  Each matrix has
+// seven nonzeros per column, and every time is the mean over 20 repetitions.
+//
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+using namespace std;
+
+#include "SparseMatrix.h"
+#include "DenseMatrix.h"
+#include "DenseView.h"
+#include "LinearOperator.h"
+#include "Real.h"
+#include "Complex.h"
+#include "Utility.h"
+using namespace DDG;
+
+const int nReps = 20;
+// number of repetitions of each operation
+
+const int nonzerosPerColumn = 7;
+// number of nonzeros in each column of the sparse matrix
+
+double magnitude( const Real& x ) { return fabs( x ); }
+double magnitude( const Complex& z ) { return z.norm(); }
+// returns the absolute value of a scalar
+
+template <class T>
+void check( const DenseMatrix<T>& y, const char* operation )
+// exits if y is not the product of the benchmark matrix with a vector of ones
+{
+   // every row receives one of each of the values 1, ..., 7
+   if( magnitude( T( y( 0 ) - T( 28. ))) > 1e-12 )
+   {
+      cerr << "error: wrong result from " << operation << endl;
+      exit( 1 );
+   }
+}
+
+template <class T>
+void benchmark( const char* name, int n )
+// prints the times of the operations on entries of type T
+{
+   SparseMatrix<T> A( n, n );
+   for( int j = 0; j < n; j++ )
+   {
+      for( int k = 0; k < nonzerosPerColumn; k++ )
+      {
+         A( ( j + 37*k ) % n, j ) = T( 1. + k );
+      }
+   }
+   SparseOperator<T> op( A );
+
+   DenseMatrix<T> x( n ), y( n );
+   for( int i = 0; i < n; i++ )
+   {
+      x( i ) = T( 1. );
+   }
+
+   double t0 = wallClock();
+   for( int rep = 0; rep < nReps; rep++ )
+   {
+      y = A*x;
+   }
+   double t1 = wallClock();
+   check( y, "A*x" );
+
+   y.zero();
+   for( int rep = 0; rep < nReps; rep++ )
+   {
+      multiply( A, DenseView<T>( x ), DenseView<T>( y ));
+   }
+   double t2 = wallClock();
+   check( y, "multiply()" );
+
+   y.zero();
+   for( int rep = 0; rep < nReps; rep++ )
+   {
+      op.apply( x, y );
+   }
+   double t3 = wallClock();
+   check( y, "SparseOperator::apply()" );
+
+   DenseMatrix<T> a( n ), b( n );
+   a.randomize();
+   b.randomize();
+
+   double t4 = wallClock();
+   for( int rep = 0; rep < nReps; rep++ )
+   {
+      a += b;
+      a *= T( .5 );
+   }
+   double t5 = wallClock();
+
+   double sink = 0.;
+   for( int rep = 0; rep < nReps; rep++ )
+   {
+      sink += a.norm( lTwo );
+   }
+   double t6 = wallClock();
+   for( int rep = 0; rep < nReps; rep++ )
+   {
+      sink += magnitude( dot( a, b ));
+   }
+   double t7 = wallClock();
+
+   cout << setw( 10 ) << name
+        << setw( 13 ) << 1e3 * ( t1 - t0 ) / nReps
+        << setw( 13 ) << 1e3 * ( t2 - t1 ) / nReps
+        << setw( 13 ) << 1e3 * ( t3 - t2 ) / nReps
+        << setw( 13 ) << 1e3 * ( t5 - t4 ) / nReps
+        << setw( 13 ) << 1e3 * ( t6 - t5 ) / nReps
+        << setw( 13 ) << 1e3 * ( t7 - t6 ) / nReps;
+
+   // keep the timed calls from being optimized away
+   if( sink == 1234.5 ) cout << " ";
+   cout << endl;
+}
+
+int main( int argc, char** argv )
+{
+   int n = 262144;
+   if( argc > 1 ) n = atoi( argv[1] );
+
+   cout << setprecision( 3 );
+   cout << setw( 10 ) << "type"
+        << setw( 13 ) << "A*x (ms)"
+        << setw( 13 ) << "mult (ms)"
+        << setw( 13 ) << "apply (ms)"
+        << setw( 13 ) << "+= *= (ms)"
+        << setw( 13 ) << "norm (ms)"
+        << setw( 13 ) << "dot (ms)" << endl;
+
+   benchmark<Real>( "Real", n );
+   benchmark<Complex>( "Complex", n );
+
+   return 0;
+}
@@ -8,7 +8,7 @@ namespace DDG
    class Complex
    {
       public:
-         Complex( double a=0., double b=0. );
+         constexpr Complex( double a=0., double b=0. );
          // constructs number a+bi
 
          void operator+=( const Complex& z );
@@ -29,10 +29,10 @@ namespace DDG
          void operator/=( const Complex& z );
          // complex divide by r
 
-         Complex operator-( void ) const;
+         constexpr Complex operator-( void ) const;
          // returns the additive inverse
 
-         Complex conj( void ) const;
+         constexpr Complex conj( void ) const;
          // returns Complex conjugate
 
          Complex inv( void ) const;
@@ -44,7 +44,7 @@ namespace DDG
          double norm( void ) const;
          // returns norm
 
-         double norm2( void ) const;
+         constexpr double norm2( void ) const;
          // returns norm squared
 
          Complex unit( void ) const;
@@ -81,14 +81,16 @@ namespace DDG
    Complex operator/( const Complex& z1, const Complex& z2 );
    // complex division
 
-   double dot( const Complex& z1, const Complex& z2 );
+   constexpr double dot( const Complex& z1, const Complex& z2 );
    // inner product
 
-   double cross( const Complex& z1, const Complex& z2 );
+   constexpr double cross( const Complex& z1, const Complex& z2 );
    // cross product
 
    std::ostream& operator<<( std::ostream& os, const Complex& o );
    // prints components
 }
 
+#include "Complex.inl"
+
 #endif
@@ -20,11 +20,23 @@
 //
 // etc.
 //
+// Columns, ranges of rows, and other blocks can be accessed in place, without
+// copying, through a DenseView (see DenseView.h), e.g.,
+//
+//    A.column(j).zero();
+//
 // DenseMatrix is interoperable with the SuiteSparse numerical linear algebra
 // library.  In particular, dereferencing a DenseMatrix returns a cholmod_dense*
 // which can be used by routines in SuiteSparse.  For basic operations, however,
 // you should not need to access this pointer explicitly -- see the solve()
-// method in SparseMatrix.h.
+// method in SparseMatrix.h.  Real and complex entries are stored exactly as
+// CHOLMOD expects, so for these types the cholmod_dense* is just a view of the
+// matrix itself: no entries are copied, and CHOLMOD routines that write into
+// it (such as cholmod_l_solve2) write directly into the matrix.
+//
+// Norms, sums, and inner products of real and complex matrices are computed
+// by vectorized, multithreaded reductions whose result does not depend on the
+// number of threads (see Reduction.h and LinearContext::reductionThreads).
 // 
 
 #ifndef DDG_DENSEMATRIX_H
@@ -54,8 +66,14 @@ namespace DDG
          DenseMatrix( const DenseMatrix<T>& A );
          // copy constructor
 
+         DenseMatrix( DenseMatrix<T>&& A );
+         // move constructor; takes the entries of A, leaving A empty
+
          const DenseMatrix<T>& operator=( const DenseMatrix<T>& B );
          // copies B
+
+         const DenseMatrix<T>& operator=( DenseMatrix<T>&& B );
+         // takes the entries of B, leaving B empty
          
          ~DenseMatrix( void );
          // destructor
@@ -69,6 +87,20 @@ namespace DDG
          int nColumns( void ) const;
          // returns the number of columns
 
+         const T* entries( void ) const;
+         // returns a pointer to the entries in column-major order
+         // (NULL if the matrix is empty)
+
+         DenseView<T> column( int col );
+         // returns a view of column col (see DenseView.h)
+
+         DenseView<T> rows( int begin, int end );
+         // returns a view of rows begin through end-1
+
+         DenseView<T> block( int row, int col, int nRows, int nColumns );
+         // returns a view of the nRows x nColumns block whose upper-left
+         // entry is (row,col)
+
          int length( void ) const;
          // returns the size of the largest dimension
 
@@ -114,11 +146,15 @@ namespace DDG
          // returns additive inverse of this matrix
 
          cholmod_dense* to_cholmod( void );
-         // returns pointer to copy of matrix in CHOLMOD format
+         // returns pointer to matrix in CHOLMOD format; for real and complex
+         // matrices this is a view of the entries (not a copy), which remains
+         // valid until the matrix is resized or destroyed; an m x n quaternionic
+         // matrix is copied into a 4m x n real matrix (one column per column)
 
          const DenseMatrix<T>& operator=( cholmod_dense* B );
          // copies a cholmod_dense* into a DenseMatrix;
-         // takes responsibility for deallocating B
+         // takes responsibility for deallocating B (nothing
+         // is copied if B is the view returned by to_cholmod())
 
          void normalize( void );
          // divides by Frobenius norm
@@ -130,12 +166,20 @@ namespace DDG
          // removes the mean
 
          void randomize( void );
-         // replaces entries with uniformly distributed random real numbers in the interval [-1,1]
+         // replaces entries with uniformly distributed random real numbers in the interval [-1,1],
+         // drawn from context.random (see LinearContext.h)
+
+         void randomize( Random& rng );
+         // same as above, but drawing from rng; the entries depend only on the state of rng
+         // (not on the number of threads used), which is advanced past the numbers drawn
 
       protected:
          int m, n;
          std::vector<T> data;
          cholmod_dense* cData;
+
+         cholmod_dense view;
+         // CHOLMOD header describing data (see to_cholmod())
    };
 
    template <class T>
@@ -169,6 +213,41 @@ namespace DDG
             const DenseMatrix<T>& y );
    // inner product with respect to a diagonal inner
    // product B represented as a dense vector
+
+   template <class T>
+   void gemm( int m, int n, int l, const T* A, const T* B, T* C );
+   // accumulates C += A*B, where A (m x l), B (l x n), and C (m x n) are
+   // stored in column-major order; uses a cache-blocked kernel
+
+   void gemm( int m, int n, int l, const Real* A, const Real* B, Real* C );
+   void gemm( int m, int n, int l, const Complex* A, const Complex* B, Complex* C );
+   // same as above, using BLAS (dgemm/zgemm) for all but small products
+
+   template <class T>
+   double reduceNorm( const T* x, int n, NormType type );
+   // returns the norm of the n entries x[0], ..., x[n-1]
+
+   template <class T>
+   T reduceSum( const T* x, int n );
+   // returns the sum of the n entries x[0], ..., x[n-1]
+
+   template <class T>
+   T reduceInner( const T* x, const T* y, int n );
+   // returns the sum of conj(x[i]) y[i] over the first n entries
+
+   template <class T>
+   T reduceInner( const T* x, const T* w, const T* y, int n );
+   // returns the sum of conj(x[i]) w[i] y[i] over the first n entries
+
+   double reduceNorm( const Real* x, int n, NormType type );
+   double reduceNorm( const Complex* x, int n, NormType type );
+   Real reduceSum( const Real* x, int n );
+   Complex reduceSum( const Complex* x, int n );
+   Real reduceInner( const Real* x, const Real* y, int n );
+   Complex reduceInner( const Complex* x, const Complex* y, int n );
+   Real reduceInner( const Real* x, const Real* w, const Real* y, int n );
+   Complex reduceInner( const Complex* x, const Complex* w, const Complex* y, int n );
+   // same as above, using the deterministic parallel kernels in Reduction.h
 }
 
 #include "DenseMatrix.inl"
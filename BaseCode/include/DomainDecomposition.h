@@ -0,0 +1,112 @@
+// -----------------------------------------------------------------------------
+// libDDG -- DomainDecomposition.h
+// -----------------------------------------------------------------------------
+//
+// DomainDecomposition is a two-level additive Schwarz preconditioner for
+// positive-definite (real symmetric or complex Hermitian) systems on large
+// meshes.  The unknowns are split into subdomains (see MeshPartition.h), each
+// subdomain is grown by a few layers of neighbors so that adjacent subdomains
+// overlap, and the diagonal block of A belonging to each subdomain is factored
+// with CHOLMOD.  Applying the preconditioner solves all subdomain problems
+// independently and adds up the results, plus a coarse correction with one
+// unknown per subdomain (the subdomain indicator functions) that propagates
+// information globally.  Factorization and subdomain solves run in parallel
+// (see ThreadPool.h), and each factor only needs memory for its subdomain.
+// The preconditioner is used with conjugate gradients:
+//
+//    MeshPartition partition;
+//    partition.build( mesh, 16 );
+//
+//    DomainDecomposition<Real> M;
+//    M.build( A, partition );
+//    solveConjugateGradient( A, M, x, b );
+//
+// or, equivalently, solvePositiveDefinite( partition, A, x, b ).
+//
+
+#ifndef DDG_DOMAINDECOMPOSITION_H
+#define DDG_DOMAINDECOMPOSITION_H
+
+#include <cholmod.h>
+#include <vector>
+#include "Types.h"
+#include "SparseMatrix.h"
+#include "DenseMatrix.h"
+#include "Preconditioner.h"
+#include "MeshPartition.h"
+#include "ThreadPool.h"
+
+namespace DDG
+{
+   template <class T>
+   class DomainDecomposition : public Preconditioner<T>
+   {
+      public:
+         DomainDecomposition( void );
+         // constructs an empty preconditioner
+
+         virtual ~DomainDecomposition( void );
+         // destructor
+
+         void build( SparseMatrix<T>& A, const MeshPartition& partition );
+         // factors the (overlapping) subdomain blocks of A and the coarse operator
+
+         virtual void apply( const DenseMatrix<T>& r, DenseMatrix<T>& z ) const;
+         // computes z = M^-1 r
+
+         bool valid( void ) const;
+         // returns true if every subdomain block was factored successfully;
+         // build() fails for a subdomain whose block is singular (e.g., if the
+         // overlap grows it to cover a whole component of a pure Laplacian),
+         // and apply() must then not be used
+
+         int nSubdomains( void ) const;
+         // returns the number of subdomains
+
+         int overlap;
+         // number of layers of neighbors added to each subdomain (default: 1)
+
+         bool coarseCorrection;
+         // whether to include the coarse-level correction (default: true)
+
+         int nThreads;
+         // number of threads (default: 0, one per processor)
+
+      protected:
+         void clear( void );
+         // releases all factors
+
+         std::vector< std::vector<UF_long> > subdomains;
+         // rows of A belonging to each overlapping subdomain
+
+         std::vector<cholmod_factor*> factors;
+         // Cholesky factor of the diagonal block of each subdomain (NULL if
+         // factorization failed)
+
+         std::vector<int> parts;
+         // (non-overlapping) subdomain of each row, which defines the coarse space
+
+         cholmod_factor* coarse;
+         // Cholesky factor of the coarse operator R0 A R0^*
+
+         int nFailed;
+         // number of subdomain blocks that could not be factored
+
+      private:
+         DomainDecomposition( const DomainDecomposition& );
+         const DomainDecomposition& operator=( const DomainDecomposition& );
+         // copying is not supported
+   };
+
+   template <class T>
+   void solvePositiveDefinite( const MeshPartition& partition,
+                               SparseMatrix<T>& A,
+                               DenseMatrix<T>& x,
+                               DenseMatrix<T>& b );
+   // solves the positive definite sparse linear system Ax = b using conjugate
+   // gradients preconditioned by domain decomposition over the given partition
+}
+
+#include "DomainDecomposition.inl"
+
+#endif
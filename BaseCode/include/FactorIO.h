@@ -0,0 +1,50 @@
+// -----------------------------------------------------------------------------
+// libDDG -- FactorIO.h
+// -----------------------------------------------------------------------------
+//
+// FactorIO saves and restores CHOLMOD factorizations (simplicial or supernodal,
+// real or complex) in a binary file, so that a program restarted on the same
+// mesh can skip the factorization altogether.  Each file records a hash of the
+// matrix that was factored; read() refuses to load a factor whose hash does not
+// match the matrix it is given, or that fails cholmod_l_check_factor.
+// Usually these routines are called through SparseFactor:
+//
+//    SparseFactor<Real> L;
+//    std::string filename = SparseFactor<Real>::filename( "bunny.obj" );
+//
+//    if( L.read( filename, A ) != 0 )
+//    {
+//       L.build( A );
+//       L.write( filename );
+//    }
+//
+// Files are not portable between machines with different word sizes or byte
+// orders; such files are rejected by read().
+//
+
+#ifndef DDG_FACTORIO_H
+#define DDG_FACTORIO_H
+
+#include <cholmod.h>
+#include <string>
+
+namespace DDG
+{
+   class FactorIO
+   {
+      public:
+         static int write( const std::string& filename, const cholmod_factor* L, unsigned long hash );
+         // writes L and the hash of the factored matrix to the given file;
+         // return value is nonzero only if there was an error
+
+         static cholmod_factor* read( const std::string& filename, unsigned long hash, int xtype, cholmod_common* common );
+         // reads a factor from the given file, provided it was computed from a
+         // matrix with the given hash and entry type and is internally
+         // consistent; returns NULL otherwise
+
+         static unsigned long hash( cholmod_sparse* A );
+         // returns a hash of the size, symmetry type, pattern, and values of A
+   };
+}
+
+#endif
@@ -0,0 +1,69 @@
+// -----------------------------------------------------------------------------
+// libDDG -- GraphColoring.h
+// -----------------------------------------------------------------------------
+//
+// GraphColoring assigns a color to each vertex of a graph so that no two
+// adjacent vertices share a color.  The graph is either the vertex adjacency
+// of a mesh or the sparsity pattern of a (structurally symmetric) matrix; in
+// both cases rows/vertices of the same color are independent, and may be
+// processed in parallel (see MulticolorGaussSeidel.h).  For example,
+//
+//    GraphColoring coloring;
+//    coloring.build( mesh );
+//
+//    for( int c = 0; c < coloring.nColors(); c++ )
+//    {
+//       for( int k = coloring.offsets[c]; k < coloring.offsets[c+1]; k++ )
+//       {
+//          int i = coloring.members[k];
+//          // ...vertex i has color c...
+//       }
+//    }
+//
+// Colors are chosen greedily (each vertex gets the smallest color not used by
+// any of its neighbors), so a graph of maximum degree d needs at most d+1
+// colors; typical triangle meshes need six to eight.
+//
+
+#ifndef DDG_GRAPHCOLORING_H
+#define DDG_GRAPHCOLORING_H
+
+#include <cholmod.h>
+#include <vector>
+#include "Types.h"
+
+namespace DDG
+{
+   class GraphColoring
+   {
+      public:
+         void build( const Mesh& mesh );
+         // colors the vertices of mesh, where two vertices are adjacent if
+         // they share an edge
+
+         void build( const cholmod_sparse* A );
+         // colors the rows of the square matrix A, where rows i and j are
+         // adjacent if A_ij or A_ji is nonzero (the pattern of A is assumed
+         // to be symmetric)
+
+         int nColors( void ) const;
+         // returns the number of colors used
+
+         int size( void ) const;
+         // returns the number of vertices
+
+         std::vector<int> colors;
+         // color of each vertex
+
+         std::vector<int> offsets;
+         std::vector<int> members;
+         // vertices of color c are members[offsets[c]] through members[offsets[c+1]-1]
+
+      protected:
+         void build( const std::vector<int>& adjacencyOffsets, const std::vector<int>& adjacency );
+         // greedily colors a graph given by neighbor lists, and groups
+         // vertices by color
+   };
+}
+
+#endif
@@ -0,0 +1,154 @@
+// -----------------------------------------------------------------------------
+// libDDG -- PlanarMatrix.h
+// -----------------------------------------------------------------------------
+//
+// PlanarMatrix is an alternative storage layout for complex and quaternionic
+// matrices.  Whereas DenseMatrix stores an array of entries (so that the
+// components of consecutive entries are interleaved), PlanarMatrix stores
+// each component in its own plane: all real parts, then all imaginary parts
+// (and, for quaternions, the j and k parts).  Every plane is a column-major
+// array of doubles that starts on a cache line boundary.  Elementwise
+// arithmetic, norms, and inner products therefore run over plain arrays of
+// doubles, which the compiler can vectorize without shuffling components.
+// For example,
+//
+//    PlanarMatrix<Complex> x( A ), y( B ); // copies of DenseMatrix A and B
+//    x += y;
+//    Complex z = inner( x, y );
+//    x.dense( A );                         // copies the result back into A
+//
+// Entries can also be read and written individually, though this is slower
+// than for DenseMatrix since each access touches several planes.
+//
+// At the CHOLMOD boundary, a complex PlanarMatrix is described without any
+// copying by a cholmod_dense of type CHOLMOD_ZOMPLEX (which likewise keeps
+// real and imaginary parts in separate arrays); quaternionic matrices are
+// copied into the same 4m by n real layout used by DenseMatrix<Quaternion>.
+// Assigning a cholmod_dense* converts from either complex layout.
+//
+
+#ifndef DDG_PLANARMATRIX_H
+#define DDG_PLANARMATRIX_H
+
+#include <cholmod.h>
+#include "Types.h"
+#include "DenseMatrix.h"
+
+namespace DDG
+{
+   template <class T>
+   class PlanarMatrix
+   {
+      public:
+         PlanarMatrix( int m = 0, int n = 1 );
+         // initialize an mxn matrix of zeros (specifying just m yields a column vector)
+
+         PlanarMatrix( const DenseMatrix<T>& A );
+         // converts a DenseMatrix to planar storage
+
+         PlanarMatrix( const PlanarMatrix<T>& A );
+         // copy constructor
+
+         PlanarMatrix( PlanarMatrix<T>&& A );
+         // move constructor; takes the entries of A, leaving A empty
+
+         const PlanarMatrix<T>& operator=( const PlanarMatrix<T>& B );
+         // copies B
+
+         const PlanarMatrix<T>& operator=( PlanarMatrix<T>&& B );
+         // takes the entries of B, leaving B empty
+
+         ~PlanarMatrix( void );
+         // destructor
+
+         static int nPlanes( void );
+         // returns the number of components per entry (2 for Complex, 4 for Quaternion)
+
+         static T compose( const double* c );
+         // returns the entry with components c[0], ..., c[nPlanes()-1]
+
+         static void decompose( const T& a, double* c );
+         // stores the components of a in c[0], ..., c[nPlanes()-1]
+
+         int nRows( void ) const;
+         // returns the number of rows
+
+         int nColumns( void ) const;
+         // returns the number of columns
+
+         double* plane( int k );
+         const double* plane( int k ) const;
+         // returns component k of all entries, in column-major order
+
+         T operator()( int row, int col ) const;
+         T operator()( int index ) const;
+         // returns the specified entry (uses 0-based indexing)
+
+         void set( int row, int col, const T& value );
+         void set( int index, const T& value );
+         // sets the specified entry (uses 0-based indexing)
+
+         void dense( DenseMatrix<T>& A ) const;
+         // copies this matrix into A, using interleaved storage
+
+         void zero( void );
+         // sets all entries to zero
+
+         void operator+=( const PlanarMatrix<T>& B );
+         // adds B to this matrix
+
+         void operator-=( const PlanarMatrix<T>& B );
+         // subtracts B from this matrix
+
+         void operator*=( double c );
+         // multiplies this matrix by the real scalar c
+
+         double norm( NormType type = lInfinity ) const;
+         // returns the norm of the entries, viewed as one long vector
+
+         T sum( void ) const;
+         // returns the sum of all entries
+
+         cholmod_dense* to_cholmod( void );
+         // returns pointer to matrix in CHOLMOD format; for complex matrices
+         // this is a CHOLMOD_ZOMPLEX view of the planes (not a copy), which
+         // remains valid until the matrix is resized or destroyed
+
+         const PlanarMatrix<T>& operator=( cholmod_dense* B );
+         // copies a cholmod_dense* into a PlanarMatrix; takes responsibility
+         // for deallocating B (nothing is copied if B is the view returned
+         // by to_cholmod())
+
+      protected:
+         void allocate( int m, int n );
+         // allocates zeroed planes for an mxn matrix
+
+         void release( void );
+         // frees all storage
+
+         int m, n;
+         // dimensions
+
+         long stride;
+         // distance between the starts of consecutive planes (a multiple of
+         // the cache line size; padding between planes is kept at zero)
+
+         double* x;
+         // storage for all planes
+
+         cholmod_dense* cData;
+         // copy handed to CHOLMOD (quaternionic matrices only)
+
+         cholmod_dense view;
+         // CHOLMOD header describing the planes (complex matrices only)
+   };
+
+   template <class T>
+   T inner( const PlanarMatrix<T>& x,
+            const PlanarMatrix<T>& y );
+   // standard inner product (sum of conj(x_i) y_i over all entries)
+}
+
+#include "PlanarMatrix.inl"
+
+#endif
@@ -0,0 +1,81 @@
+// -----------------------------------------------------------------------------
+// libDDG -- Reduction.h
+// -----------------------------------------------------------------------------
+//
+// Reduction computes sums, maxima, and inner products of long arrays of
+// doubles; it is used by the norms and inner products of DenseMatrix<Real> and
+// DenseMatrix<Complex>.  Arrays are cut into blocks of fixed length.  Each block
+// is reduced with several independent accumulators, so that the compiler can
+// vectorize the loop for whatever SIMD instructions the target provides, and
+// the blocks of long arrays are distributed over several threads (see
+// ThreadPool.h).  Block results are then combined in order.  Since the blocks
+// do not depend on the number of threads, the result is bitwise identical from
+// run to run and for any thread count (though it may differ in the last few
+// bits from that of a plain loop).  For example,
+//
+//    double r = sqrt( Reduction::sumSquares( x, n ));
+//
+// computes the Euclidean norm of the n doubles x[0], ..., x[n-1].  Complex
+// arrays are stored as interleaved (real, imaginary) pairs, and their length n
+// is the number of complex entries (i.e., half the number of doubles).  The
+// planar routines instead take one array per component (see PlanarMatrix.h).
+// The optional argument nThreads gives the number of threads used for long
+// arrays: zero means one per processor, and one disables threading.
+//
+
+#ifndef DDG_REDUCTION_H
+#define DDG_REDUCTION_H
+
+namespace DDG
+{
+   class Reduction
+   {
+      public:
+         static double sum( const double* x, long n, int nThreads = 0 );
+         // returns x[0] + ... + x[n-1]
+
+         static double sumAbs( const double* x, long n, int nThreads = 0 );
+         // returns |x[0]| + ... + |x[n-1]|
+
+         static double maxAbs( const double* x, long n, int nThreads = 0 );
+         // returns max |x[i]| (or zero if n is zero)
+
+         static double sumSquares( const double* x, long n, int nThreads = 0 );
+         // returns x[0]^2 + ... + x[n-1]^2
+
+         static double dot( const double* x, const double* y, long n, int nThreads = 0 );
+         // returns x[0]y[0] + ... + x[n-1]y[n-1]
+
+         static double dot( const double* x, const double* w, const double* y, long n, int nThreads = 0 );
+         // returns x[0]w[0]y[0] + ... + x[n-1]w[n-1]y[n-1]
+
+         static void complexSum( const double* z, long n, double& re, double& im, int nThreads = 0 );
+         // stores the sum of the complex numbers z[0], ..., z[n-1] in (re,im)
+
+         static double complexSumAbs( const double* z, long n, int nThreads = 0 );
+         // returns |z[0]| + ... + |z[n-1]| for complex z
+
+         static double complexMaxAbs( const double* z, long n, int nThreads = 0 );
+         // returns max |z[i]| (or zero if n is zero) for complex z
+
+         static void complexDot( const double* x, const double* y, long n, double& re, double& im, int nThreads = 0 );
+         // stores the sum of conj(x[i]) y[i] over complex x and y in (re,im)
+
+         static void complexDot( const double* x, const double* w, const double* y, long n, double& re, double& im, int nThreads = 0 );
+         // stores the sum of conj(x[i]) w[i] y[i] over complex x, w, and y in (re,im)
+
+         static void dots( int nPairs, const double* const* x, const double* const* y, long n, double* r, int nThreads = 0 );
+         // stores the dot product of the arrays x[p] and y[p] (each of length n)
+         // in r[p], for p = 0, ..., nPairs-1; all pairs are reduced together,
+         // one block at a time, so the data is read from memory only once
+
+         static double planarSumAbs( int nPlanes, const double* const* x, long n, int nThreads = 0 );
+         // returns |a[0]| + ... + |a[n-1]|, where a[i] is the vector with
+         // components x[0][i], ..., x[nPlanes-1][i]
+
+         static double planarMaxAbs( int nPlanes, const double* const* x, long n, int nThreads = 0 );
+         // returns max |a[i]| (or zero if n is zero) for a[i] as above
+   };
+}
+
+#endif
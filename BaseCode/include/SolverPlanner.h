@@ -0,0 +1,98 @@
+// -----------------------------------------------------------------------------
+// libDDG -- SolverPlanner.h
+// -----------------------------------------------------------------------------
+//
+// SolverPlanner decides how solvePositiveDefinite should solve a given system.
+// The symbolic Cholesky analysis performed before every factorization predicts
+// the size of the factor and the number of floating point operations needed to
+// compute it; if either exceeds the configured budget, the planner falls back
+// to a strategy that needs less memory:
+//
+//    1. supernodal Cholesky (the default, fastest direct method)
+//    2. simplicial LDL^T (no supernodal padding or dense workspace; if a zero
+//       pivot is encountered, one of the iterative methods below is used,
+//       never LU, whose factors would be larger still)
+//    3. geometric multigrid (if a hierarchy for the mesh has been provided)
+//    4. preconditioned conjugate gradients (needs only O(nnz(A)) memory)
+//
+// The global LinearContext holds a planner whose memory budget defaults to half
+// of the physical memory of the machine.  For example, to solve on a large scan
+// within 2GB and ten seconds of factorization time,
+//
+//    extern LinearContext context;
+//    context.planner.memoryBudget = 2e9;
+//    context.planner.timeBudget = 10.;
+//    context.planner.hierarchy = &hierarchy; // optional
+//
+//    solvePositiveDefinite( A, x, b );
+//
+// The strategy that was chosen is recorded in the solver statistics (see
+// SolverStats.h), along with the predicted memory and time.
+//
+
+#ifndef DDG_SOLVERPLANNER_H
+#define DDG_SOLVERPLANNER_H
+
+#include <cholmod.h>
+#include "Types.h"
+
+namespace DDG
+{
+   enum SolverStrategy
+   {
+      strategyCholesky,
+      strategyLDLT,
+      strategyMultigrid,
+      strategyConjugateGradient
+   };
+
+   class SolverPlan
+   {
+      public:
+         SolverStrategy strategy;
+         // chosen strategy
+
+         double memory;
+         // predicted size of the supernodal Cholesky factor, in bytes
+
+         double time;
+         // predicted time of the supernodal Cholesky factorization, in seconds
+   };
+
+   class SolverPlanner
+   {
+      public:
+         SolverPlanner( void );
+         // constructs a planner with default budgets
+
+         SolverPlan plan( cholmod_sparse* A, cholmod_factor* L, cholmod_common* common ) const;
+         // chooses a strategy for the matrix A, given its symbolic factor L
+         // (as returned by LinearContext::analyze)
+
+         SolverStrategy iterative( int n ) const;
+         // returns the iterative strategy used for an n x n matrix when no
+         // factorization fits (multigrid if hierarchy matches, otherwise
+         // conjugate gradients)
+
+         static const char* name( SolverStrategy strategy );
+         // returns a human-readable name for a strategy
+
+         static double physicalMemory( void );
+         // returns the size of the physical memory of the machine, in bytes
+
+         double memoryBudget;
+         // maximum size of a sparse factor, in bytes; zero means unlimited
+         // (default: half of the physical memory)
+
+         double timeBudget;
+         // maximum predicted factorization time, in seconds; zero means unlimited (default: 0)
+
+         double flopRate;
+         // assumed speed of the factorization, in floating point operations per second (default: 1e9)
+
+         const MeshHierarchy* hierarchy;
+         // hierarchy used for multigrid solves, or NULL if multigrid should not be used (default: NULL)
+   };
+}
+
+#endif
@@ -0,0 +1,107 @@
+// -----------------------------------------------------------------------------
+// libDDG -- ThreadPool.h
+// -----------------------------------------------------------------------------
+//
+// ThreadPool runs a batch of independent tasks on several threads.  Tasks are
+// dealt round-robin to per-thread queues; each thread takes work from the front
+// of its own queue and, once that queue is empty, steals from the back of the
+// others, so that threads which draw short tasks help out with the long ones.
+// Since every thread has its own CHOLMOD workspace (see LinearContext.h), tasks
+// may call any of the sparse solvers.  For example,
+//
+//    class MyTask : public ThreadPool::Task
+//    {
+//       public:
+//          virtual void run( void ) { ... }
+//    };
+//
+//    std::vector<ThreadPool::Task*> tasks;
+//    // ...fill tasks...
+//
+//    ThreadPool pool;
+//    pool.run( tasks );
+//
+// run() returns once all tasks have finished.  Tasks must not modify data
+// shared with other tasks in the same batch.
+//
+// The worker threads are started the first time they are needed and are shared
+// by all pools; between batches they sleep on a condition variable, and their
+// CHOLMOD workspaces persist.  Constructing a ThreadPool is therefore cheap, and
+// run() may be called on every iteration of a solver.  Batches do not nest: if
+// run() is called from within a task, or while the workers are busy with a
+// batch submitted by another thread, the tasks simply run on the calling thread.
+//
+
+#ifndef DDG_THREADPOOL_H
+#define DDG_THREADPOOL_H
+
+#include <pthread.h>
+#include <deque>
+#include <vector>
+
+namespace DDG
+{
+   class ThreadPool
+   {
+      public:
+         class Task
+         {
+            public:
+               virtual ~Task( void );
+               // destructor
+
+               virtual void run( void ) = 0;
+               // performs the work
+         };
+
+         ThreadPool( int nThreads = 0 );
+         // constructs a pool with the given number of threads; if nThreads is
+         // zero, one thread is used per available processor
+
+         ~ThreadPool( void );
+         // destructor
+
+         void run( const std::vector<Task*>& tasks );
+         // executes all tasks and waits for them to finish
+
+         int nThreads( void ) const;
+         // returns the number of threads used by run()
+
+         static int nProcessors( void );
+         // returns the number of available processors
+
+      protected:
+         class Queue
+         {
+            public:
+               Queue( void );
+               ~Queue( void );
+
+               pthread_mutex_t mutex;
+               std::deque<Task*> tasks;
+         };
+
+         class Workers;
+         // worker threads shared by all pools (see ThreadPool.cpp)
+
+         static void* work( void* index );
+         // worker thread entry point; waits for batches and helps run their tasks
+
+         void runInline( const std::vector<Task*>& tasks );
+         // runs all tasks on the calling thread
+
+         Task* next( int index );
+         // removes the next task for thread index from its own queue, or
+         // steals one from another queue; returns NULL if no work is left
+
+         std::vector<Queue*> queues;
+         // one queue of pending tasks per thread
+
+      private:
+         ThreadPool( const ThreadPool& );
+         const ThreadPool& operator=( const ThreadPool& );
+         // copying is not supported
+   };
+}
+
+#endif
@@ -27,8 +27,10 @@ namespace DDG
    class LinearPolynomial;
    class LinearSystem;
    class Mesh;
+   class MeshHierarchy;
    class MeshIO;
    class Quaternion;
+   class Random;
    class Real;
    class Shader;
    class Variable;
@@ -39,8 +41,20 @@ namespace DDG
    template <class T>
    class DenseMatrix;
 
+   template <class T>
+   class DenseView;
+
    template <class T>
    class SparseMatrix;
+
+   template <class T>
+   class IncompleteCholesky;
+
+   template <class T>
+   class Multigrid;
+
+   template <class T>
+   class SparseOperator;
    
    // convenience types for iterators
    typedef std::map<Variable*,double>::iterator            TermIter;
@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+using namespace std;
+
+#include "ConjugateGradient.h"
+#include "LinearContext.h"
+#include "Real.h"
+#include "Complex.h"
+#include "Utility.h"
+
+namespace DDG
+{
+   extern LinearContext context;
+
+   template <class T>
+   void conjugateGradient( const LinearOperator<T>& A,
+                           const Preconditioner<T>& M,
+                                  DenseMatrix<T>& x,
+                                  DenseMatrix<T>& b,
+                           double tolerance,
+                           int maxIterations,
+                           SolverStats& stats )
+   // solves the positive definite linear system Ax = b using preconditioned conjugate
+   // gradients, storing (but not reporting) the statistics of the solve in stats
+   {
+      assert( A.size() == b.nRows() );
+
+      Timer timer;
+      int n = A.size();
+
+      if( &x == &b )
+      {
+         DenseMatrix<T> bCopy( b );
+         conjugateGradient( A, M, x, bCopy, tolerance, maxIterations, stats );
+         return;
+      }
+
+      if( x.nRows() != b.nRows() || x.nColumns() != b.nColumns() )
+      {
+         x = DenseMatrix<T>( b.nRows(), b.nColumns() );
+      }
+
+      int maxIter = 0;
+      double maxResidual = 0.;
+      DenseMatrix<T> xc( n ), r( n ), z( n ), p( n ), q( n );
+      for( int c = 0; c < b.nColumns(); c++ )
+      {
+         double bNorm2 = 0.;
+         for( int i = 0; i < n; i++ )
+         {
+            xc( i ) = x( i, c );
+            bNorm2 += b( i, c ).norm2();
+         }
+         if( bNorm2 == 0. )
+         {
+            for( int i = 0; i < n; i++ ) x( i, c ) = 0.;
+            continue;
+         }
+
+         // r = b - Ax, z = M^-1 r, p = z (q holds A times a vector)
+         A.apply( xc, q );
+         double rNorm2 = 0.;
+         for( int i = 0; i < n; i++ )
+         {
+            r( i ) = b( i, c );
+            r( i ) -= q( i );
+            rNorm2 += r( i ).norm2();
+         }
+         M.apply( r, z );
+         p = z;
+         double rz = 0.;
+         for( int i = 0; i < n; i++ )
+         {
+            rz += realPart( r( i ).conj() * z( i ));
+         }
+
+         int iter = 0;
+         while( iter < maxIterations && rNorm2 > tolerance*tolerance*bNorm2 )
+         {
+            A.apply( p, q );
+
+            double pAp = 0.;
+            for( int i = 0; i < n; i++ )
+            {
+               pAp += realPart( p( i ).conj() * q( i ));
+            }
+            if( pAp <= 0. ) break; // A is not positive-definite (or p vanished)
+
+            double alpha = rz / pAp;
+            rNorm2 = 0.;
+            for( int i = 0; i < n; i++ )
+            {
+               xc( i ) += alpha * p( i );
+               r( i ) -= alpha * q( i );
+               rNorm2 += r( i ).norm2();
+            }
+
+            M.apply( r, z );
+            double rzNew = 0.;
+            for( int i = 0; i < n; i++ )
+            {
+               rzNew += realPart( r( i ).conj() * z( i ));
+            }
+
+            double beta = rzNew / rz;
+            rz = rzNew;
+            for( int i = 0; i < n; i++ )
+            {
+               p( i ) = z( i ) + beta * p( i );
+            }
+
+            iter++;
+         }
+
+         for( int i = 0; i < n; i++ )
+         {
+            x( i, c ) = xc( i );
+         }
+
+         maxIter = max( maxIter, iter );
+         maxResidual = max( maxResidual, sqrt( rNorm2 / bNorm2 ));
+      }
+
+      stats.clear();
+      stats.solver = "pcg";
+      timer.stop( stats );
+      stats.iterations = maxIter;
+      stats.residual = maxResidual;
+   }
+
+   template <class T>
+   int solveConjugateGradient( const LinearOperator<T>& A,
+                                      DenseMatrix<T>& x,
+                                      DenseMatrix<T>& b,
+                               double tolerance,
+                               int maxIterations )
+   // solves the positive definite linear system Ax = b using preconditioned conjugate gradients
+   {
+      JacobiPreconditioner<T> M;
+      M.build( A );
+
+      return solveConjugateGradient( A, M, x, b, tolerance, maxIterations );
+   }
+
+   template <class T>
+   int solveConjugateGradient( const LinearOperator<T>& A,
+                               const Preconditioner<T>& M,
+                                      DenseMatrix<T>& x,
+                                      DenseMatrix<T>& b,
+                               double tolerance,
+                               int maxIterations )
+   // solves the positive definite linear system Ax = b using conjugate gradients preconditioned by M
+   {
+      SolverStats stats;
+      conjugateGradient( A, M, x, b, tolerance, maxIterations, stats );
+      context.report( stats );
+
+      return stats.iterations;
+   }
+
+   template <class T>
+   int solveConjugateGradient( SparseMatrix<T>& A,
+                                DenseMatrix<T>& x,
+                                DenseMatrix<T>& b,
+                               double tolerance,
+                               int maxIterations )
+   // solves the positive definite sparse linear system Ax = b using preconditioned conjugate gradients
+   {
+      assert( A.nRows() == A.nColumns() );
+      assert( A.nRows() == b.nRows() );
+
+      SparseOperator<T> op( A );
+      JacobiPreconditioner<T> M;
+      M.build( op );
+
+      SolverStats stats;
+      conjugateGradient( op, M, x, b, tolerance, maxIterations, stats );
+      stats.nnzA = op.nnz();
+      context.report( stats );
+
+      return stats.iterations;
+   }
+
+   template <class T>
+   int solveConjugateGradient( SparseMatrix<T>& A,
+                               const Preconditioner<T>& M,
+                                DenseMatrix<T>& x,
+                                DenseMatrix<T>& b,
+                               double tolerance,
+                               int maxIterations )
+   // solves the positive definite sparse linear system Ax = b using conjugate gradients preconditioned by M
+   {
+      assert( A.nRows() == A.nColumns() );
+      assert( A.nRows() == b.nRows() );
+
+      SparseOperator<T> op( A );
+      SolverStats stats;
+      conjugateGradient( op, M, x, b, tolerance, maxIterations, stats );
+      stats.nnzA = op.nnz();
+      context.report( stats );
+
+      return stats.iterations;
+   }
+
+   template <class T>
+   void smallestEigPositiveDefinite( const LinearOperator<T>& A,
+                                            DenseMatrix<T>& x,
+                                            bool ignoreConstantVector )
+   // solves A x = lambda x for the smallest nonzero eigenvalue lambda using inverse
+   // iteration, where each step is solved by preconditioned conjugate gradients
+   {
+      Timer timer;
+      SolverStats stats;
+      JacobiPreconditioner<T> M;
+      M.build( A );
+      for( int iter = 0; iter < maxEigIter; iter++ )
+      {
+         conjugateGradient( A, M, x, x, 1e-10, 1000, stats );
+         if( ignoreConstantVector )
+         {
+            x.removeMean();
+         }
+         x.normalize();
+      }
+
+      double maxResidual = -1.;
+      if( context.checkResidual() )
+      {
+         DenseMatrix<T> Ax;
+         A.apply( x, Ax );
+         T lambda = dot( x, Ax ) / dot( x, x );
+         maxResidual = ( Ax - lambda*x ).norm() / x.norm();
+      }
+      reportEig( timer, maxResidual );
+   }
+}
@@ -3,9 +3,11 @@
 
 #include <algorithm>
 #include <iostream>
+#include <utility>
 using namespace std;
 
 #include "DenseMatrix.h"
+#include "DenseView.h"
 #include "LinearContext.h"
 #include "Quaternion.h"
 #include "SparseMatrix.h"
@@ -34,6 +36,14 @@ namespace DDG
       *this = A;
    }
 
+   template <class T>
+   DenseMatrix<T> :: DenseMatrix( DenseMatrix<T>&& A )
+   // move constructor
+   : cData( NULL )
+   {
+      *this = std::move( A );
+   }
+
    template <class T>
    DenseMatrix<T> :: ~DenseMatrix( void )
    // destructor
@@ -81,11 +91,9 @@ namespace DDG
 
       DenseMatrix<T> AB( A.nRows(), B.nColumns() );
 
-      for( int i = 0; i < A.nRows(); i++ )
-      for( int j = 0; j < B.nColumns(); j++ )
-      for( int k = 0; k < A.nColumns(); k++ )
+      if( A.nRows() > 0 && A.nColumns() > 0 && B.nColumns() > 0 )
       {
-         AB( i, j ) += A( i, k ) * B( k, j );
+         gemm( A.nRows(), B.nColumns(), A.nColumns(), &A.data[0], &B.data[0], &AB.data[0] );
       }
 
       return AB;
@@ -232,6 +240,32 @@ namespace DDG
       return *this;
    }
 
+   template <class T>
+   const DenseMatrix<T>& DenseMatrix<T> :: operator=( DenseMatrix<T>&& B )
+   // takes the entries of B, leaving B empty
+   {
+      if( this == &B )
+      {
+         return *this;
+      }
+
+      if( cData )
+      {
+         cholmod_l_free_dense( &cData, context );
+      }
+
+      m = B.m;
+      n = B.n;
+      data = std::move( B.data );
+      cData = B.cData;
+
+      B.m = 0;
+      B.data.clear();
+      B.cData = NULL;
+
+      return *this;
+   }
+
    template <class T>
    int DenseMatrix<T> :: nRows( void ) const
    // returns the number of rows
@@ -246,6 +280,34 @@ namespace DDG
       return n;
    }
 
+   template <class T>
+   const T* DenseMatrix<T> :: entries( void ) const
+   // returns a pointer to the entries in column-major order
+   {
+      return data.empty() ? NULL : &data[0];
+   }
+
+   template <class T>
+   DenseView<T> DenseMatrix<T> :: column( int col )
+   // returns a view of column col
+   {
+      return DenseView<T>( *this ).column( col );
+   }
+
+   template <class T>
+   DenseView<T> DenseMatrix<T> :: rows( int begin, int end )
+   // returns a view of rows begin through end-1
+   {
+      return DenseView<T>( *this ).rows( begin, end );
+   }
+
+   template <class T>
+   DenseView<T> DenseMatrix<T> :: block( int row, int col, int nRows, int nColumns )
+   // returns a view of the nRows x nColumns block starting at (row,col)
+   {
+      return DenseView<T>( *this ).block( row, col, nRows, nColumns );
+   }
+
    template <class T>
    int DenseMatrix<T> :: length( void ) const
    // returns the size of the largest dimension
@@ -266,32 +328,7 @@ namespace DDG
    template <class T>
    double DenseMatrix<T> :: norm( NormType type ) const
    {
-      double r = 0.;
-
-      if( type == lInfinity )
-      {
-         for( int i = 0; i < m*n; i++ )
-         {
-            r = max( r, data[i].norm() );
-         }
-      }
-      else if( type == lOne )
-      {
-         for( int i = 0; i < m*n; i++ )
-         {
-            r += data[i].norm();
-         }
-      }
-      else if( type == lTwo )
-      {
-         for( int i = 0; i < m*n; i++ )
-         {
-            r += data[i].norm2();
-         }
-         r = sqrt( r );
-      }
-
-      return r;
+      return reduceNorm( entries(), m*n, type );
    }
 
    template <class T>
@@ -329,26 +366,14 @@ namespace DDG
    T DenseMatrix<T>::sum( void ) const
    // returns the sum of all entries
    {
-      T total( 0., 0. );
-
-      for( int i = 0; i < m*n; i++ )
-      {
-         total += data[i];
-      }
-
-      return total;
+      return reduceSum( entries(), m*n );
    }
 
    template <class T>
    void DenseMatrix<T> :: removeMean( void )
    {
-      T mean = 0.;
       int N = m*n;
-
-      for( int i = 0; i < N; i++ )
-      {
-         mean += data[i];
-      }
+      T mean = reduceSum( entries(), N );
 
       mean /= (double) N;
 
@@ -362,7 +387,10 @@ namespace DDG
    T dot( const DenseMatrix<T>& x, const DenseMatrix<T>& y )
    // returns Euclidean inner product of x and y
    {
-      return ( x.transpose() * y )(0);
+      assert( x.nRows() == y.nRows() );
+
+      // i.e., the first entry of x^* y
+      return reduceInner( x.entries(), y.entries(), x.nRows() );
    }
 
    template <class T>
@@ -386,17 +414,10 @@ namespace DDG
             const DenseMatrix<T>& y )
    // standard inner product
    {
-      T sum = 0.;
-
       assert( x.nRows()    == y.nRows() &&
               x.nColumns() == y.nColumns() );
 
-      for( int i = 0; i < x.nRows()*x.nColumns(); i++ )
-      {
-         sum += x(i).conj() * y(i);
-      }
-
-      return sum;
+      return reduceInner( x.entries(), y.entries(), x.nRows()*x.nColumns() );
    }
 
    template <class T>
@@ -406,20 +427,124 @@ namespace DDG
    // inner product with respect a diagonal inner
    // product B represented as a dense vector
    {
-      T sum = 0.;
-
       assert( x.nRows() == y.nRows() &&
               x.nRows() == B.nRows() &&
               x.nColumns() == 1 &&
               B.nColumns() == 1 &&
               y.nColumns() == 1 );
 
-      for( int i = 0; i < x.nRows()*x.nColumns(); i++ )
+      return reduceInner( x.entries(), B.entries(), y.entries(), x.nRows() );
+   }
+
+   template <class T>
+   void gemm( int m, int n, int l, const T* A, const T* B, T* C )
+   // accumulates C += A*B, where A (m x l), B (l x n), and C (m x n) are
+   // stored in column-major order
+   {
+      // C is updated one column at a time by unit-stride passes over
+      // columns of A; rows are processed in blocks so that the block of C
+      // stays in cache while a block of columns of A streams through it
+      const int rowBlock = 2048;
+      const int innerBlock = 64;
+
+      for( int i0 = 0; i0 < m; i0 += rowBlock )
+      {
+         int i1 = std::min( i0 + rowBlock, m );
+
+         for( int k0 = 0; k0 < l; k0 += innerBlock )
+         {
+            int k1 = std::min( k0 + innerBlock, l );
+
+            for( int j = 0; j < n; j++ )
+            {
+               T* c = C + m*j;
+
+               for( int k = k0; k < k1; k++ )
+               {
+                  const T b = B[ k + l*j ];
+                  const T* a = A + m*k;
+
+                  for( int i = i0; i < i1; i++ )
+                  {
+                     c[i] += a[i] * b;
+                  }
+               }
+            }
+         }
+      }
+   }
+
+   template <class T>
+   double reduceNorm( const T* x, int n, NormType type )
+   // returns the norm of the n entries x[0], ..., x[n-1]
+   {
+      double r = 0.;
+
+      if( type == lInfinity )
+      {
+         for( int i = 0; i < n; i++ )
+         {
+            r = max( r, x[i].norm() );
+         }
+      }
+      else if( type == lOne )
+      {
+         for( int i = 0; i < n; i++ )
+         {
+            r += x[i].norm();
+         }
+      }
+      else if( type == lTwo )
+      {
+         for( int i = 0; i < n; i++ )
+         {
+            r += x[i].norm2();
+         }
+         r = sqrt( r );
+      }
+
+      return r;
+   }
+
+   template <class T>
+   T reduceSum( const T* x, int n )
+   // returns the sum of the n entries x[0], ..., x[n-1]
+   {
+      T total = 0.;
+
+      for( int i = 0; i < n; i++ )
       {
-         sum += x(i).conj() * B(i) * y(i);
+         total += x[i];
+      }
+
+      return total;
+   }
+
+   template <class T>
+   T reduceInner( const T* x, const T* y, int n )
+   // returns the sum of conj(x[i]) y[i] over the first n entries
+   {
+      T sum = 0.;
+
+      for( int i = 0; i < n; i++ )
+      {
+         sum += x[i].conj() * y[i];
       }
 
       return sum;
    }
-}
 
+   template <class T>
+   T reduceInner( const T* x, const T* w, const T* y, int n )
+   // returns the sum of conj(x[i]) w[i] y[i] over the first n entries
+   {
+      T sum = 0.;
+
+      for( int i = 0; i < n; i++ )
+      {
+         sum += x[i].conj() * w[i] * y[i];
+      }
+
+      return sum;
+   }
+}
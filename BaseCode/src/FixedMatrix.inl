@@ -0,0 +1,473 @@
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+
+namespace DDG
+{
+   template <int N>
+   constexpr int FixedMatrix<N> :: size;
+
+   template <int N>
+   FixedMatrix<N> :: FixedMatrix( void )
+   // initializes all entries to zero
+   {
+      for( int i = 0; i < N; i++ )
+      for( int j = 0; j < N; j++ )
+      {
+         entries[i][j] = 0.;
+      }
+   }
+
+   template <int N>
+   FixedMatrix<N> FixedMatrix<N> :: identity( void )
+   // returns the N x N identity matrix
+   {
+      FixedMatrix<N> I;
+
+      for( int i = 0; i < N; i++ )
+      {
+         I.entries[i][i] = 1.;
+      }
+
+      return I;
+   }
+
+   template <int N>
+   double& FixedMatrix<N> :: operator()( int row, int col )
+   {
+      return entries[row][col];
+   }
+
+   template <int N>
+   double FixedMatrix<N> :: operator()( int row, int col ) const
+   {
+      return entries[row][col];
+   }
+
+   template <int N>
+   FixedMatrix<N> FixedMatrix<N> :: operator+( const FixedMatrix<N>& B ) const
+   // returns sum of this matrix with B
+   {
+      FixedMatrix<N> C( *this );
+
+      C += B;
+
+      return C;
+   }
+
+   template <int N>
+   FixedMatrix<N> FixedMatrix<N> :: operator-( const FixedMatrix<N>& B ) const
+   // returns difference of this matrix with B
+   {
+      FixedMatrix<N> C( *this );
+
+      C -= B;
+
+      return C;
+   }
+
+   template <int N>
+   FixedMatrix<N> FixedMatrix<N> :: operator*( const FixedMatrix<N>& B ) const
+   // returns product of this matrix with B
+   {
+      FixedMatrix<N> C;
+
+      for( int i = 0; i < N; i++ )
+      for( int k = 0; k < N; k++ )
+      for( int j = 0; j < N; j++ )
+      {
+         C.entries[i][j] += entries[i][k] * B.entries[k][j];
+      }
+
+      return C;
+   }
+
+   template <int N>
+   FixedMatrix<N> FixedMatrix<N> :: operator*( double c ) const
+   // returns this matrix times the scalar c
+   {
+      FixedMatrix<N> C( *this );
+
+      C *= c;
+
+      return C;
+   }
+
+   template <int N>
+   void FixedMatrix<N> :: operator+=( const FixedMatrix<N>& B )
+   // adds B to this matrix
+   {
+      for( int i = 0; i < N; i++ )
+      for( int j = 0; j < N; j++ )
+      {
+         entries[i][j] += B.entries[i][j];
+      }
+   }
+
+   template <int N>
+   void FixedMatrix<N> :: operator-=( const FixedMatrix<N>& B )
+   // subtracts B from this matrix
+   {
+      for( int i = 0; i < N; i++ )
+      for( int j = 0; j < N; j++ )
+      {
+         entries[i][j] -= B.entries[i][j];
+      }
+   }
+
+   template <int N>
+   void FixedMatrix<N> :: operator*=( double c )
+   // multiplies this matrix by the scalar c
+   {
+      for( int i = 0; i < N; i++ )
+      for( int j = 0; j < N; j++ )
+      {
+         entries[i][j] *= c;
+      }
+   }
+
+   template <int N>
+   FixedMatrix<N> FixedMatrix<N> :: transpose( void ) const
+   // returns the transpose of this matrix
+   {
+      FixedMatrix<N> AT;
+
+      for( int i = 0; i < N; i++ )
+      for( int j = 0; j < N; j++ )
+      {
+         AT.entries[j][i] = entries[i][j];
+      }
+
+      return AT;
+   }
+
+   template <int N>
+   double FixedMatrix<N> :: trace( void ) const
+   // returns the sum of the diagonal entries
+   {
+      double sum = 0.;
+
+      for( int i = 0; i < N; i++ )
+      {
+         sum += entries[i][i];
+      }
+
+      return sum;
+   }
+
+   template <int N>
+   double FixedMatrix<N> :: norm( void ) const
+   // returns the Frobenius norm
+   {
+      double sum = 0.;
+
+      for( int i = 0; i < N; i++ )
+      for( int j = 0; j < N; j++ )
+      {
+         sum += entries[i][j] * entries[i][j];
+      }
+
+      return sqrt( sum );
+   }
+
+   template <int N>
+   double FixedMatrix<N> :: determinant( void ) const
+   // returns the determinant, using Gaussian elimination with partial pivoting
+   {
+      FixedMatrix<N> LU( *this );
+      double det = 1.;
+
+      for( int k = 0; k < N; k++ )
+      {
+         int p = k;
+         for( int i = k+1; i < N; i++ )
+         {
+            if( fabs( LU.entries[i][k] ) > fabs( LU.entries[p][k] )) p = i;
+         }
+         if( LU.entries[p][k] == 0. )
+         {
+            return 0.;
+         }
+         if( p != k )
+         {
+            for( int j = 0; j < N; j++ ) std::swap( LU.entries[p][j], LU.entries[k][j] );
+            det = -det;
+         }
+
+         det *= LU.entries[k][k];
+         for( int i = k+1; i < N; i++ )
+         {
+            double l = LU.entries[i][k] / LU.entries[k][k];
+            for( int j = k+1; j < N; j++ )
+            {
+               LU.entries[i][j] -= l * LU.entries[k][j];
+            }
+         }
+      }
+
+      return det;
+   }
+
+   template <int N>
+   FixedMatrix<N> FixedMatrix<N> :: inverse( void ) const
+   // returns the inverse, using Gauss-Jordan elimination with partial pivoting
+   {
+      FixedMatrix<N> A( *this );
+      FixedMatrix<N> B = identity();
+
+      for( int k = 0; k < N; k++ )
+      {
+         int p = k;
+         for( int i = k+1; i < N; i++ )
+         {
+            if( fabs( A.entries[i][k] ) > fabs( A.entries[p][k] )) p = i;
+         }
+         assert( A.entries[p][k] != 0. );
+         for( int j = 0; j < N; j++ )
+         {
+            std::swap( A.entries[p][j], A.entries[k][j] );
+            std::swap( B.entries[p][j], B.entries[k][j] );
+         }
+
+         double r = 1. / A.entries[k][k];
+         for( int j = 0; j < N; j++ )
+         {
+            A.entries[k][j] *= r;
+            B.entries[k][j] *= r;
+         }
+
+         for( int i = 0; i < N; i++ )
+         {
+            if( i == k ) continue;
+            double l = A.entries[i][k];
+            for( int j = 0; j < N; j++ )
+            {
+               A.entries[i][j] -= l * A.entries[k][j];
+               B.entries[i][j] -= l * B.entries[k][j];
+            }
+         }
+      }
+
+      return B;
+   }
+
+   template <>
+   inline double FixedMatrix<2> :: determinant( void ) const
+   {
+      return entries[0][0]*entries[1][1] - entries[0][1]*entries[1][0];
+   }
+
+   template <>
+   inline FixedMatrix<2> FixedMatrix<2> :: inverse( void ) const
+   {
+      double r = 1. / determinant();
+      FixedMatrix<2> B;
+
+      B.entries[0][0] =  entries[1][1]*r; B.entries[0][1] = -entries[0][1]*r;
+      B.entries[1][0] = -entries[1][0]*r; B.entries[1][1] =  entries[0][0]*r;
+
+      return B;
+   }
+
+   template <>
+   inline double FixedMatrix<3> :: determinant( void ) const
+   {
+      return entries[0][0] * ( entries[1][1]*entries[2][2] - entries[1][2]*entries[2][1] )
+           - entries[0][1] * ( entries[1][0]*entries[2][2] - entries[1][2]*entries[2][0] )
+           + entries[0][2] * ( entries[1][0]*entries[2][1] - entries[1][1]*entries[2][0] );
+   }
+
+   template <>
+   inline FixedMatrix<3> FixedMatrix<3> :: inverse( void ) const
+   {
+      // inverse is the transposed cofactor matrix divided by the determinant
+      FixedMatrix<3> B;
+
+      for( int i = 0; i < 3; i++ )
+      for( int j = 0; j < 3; j++ )
+      {
+         int i1 = (i+1)%3, i2 = (i+2)%3;
+         int j1 = (j+1)%3, j2 = (j+2)%3;
+         B.entries[j][i] = entries[i1][j1]*entries[i2][j2] - entries[i1][j2]*entries[i2][j1];
+      }
+
+      double r = 1. / ( entries[0][0]*B.entries[0][0] +
+                        entries[0][1]*B.entries[1][0] +
+                        entries[0][2]*B.entries[2][0] );
+      B *= r;
+
+      return B;
+   }
+
+   template <int N>
+   FixedMatrix<N> operator*( double c, const FixedMatrix<N>& A )
+   // left scalar multiplication
+   {
+      return A*c;
+   }
+
+   inline Vector operator*( const Mat3& A, const Vector& v )
+   // returns the product of a 3x3 matrix with a vector
+   {
+      return Vector( A(0,0)*v.x + A(0,1)*v.y + A(0,2)*v.z,
+                     A(1,0)*v.x + A(1,1)*v.y + A(1,2)*v.z,
+                     A(2,0)*v.x + A(2,1)*v.y + A(2,2)*v.z );
+   }
+
+   template <int N>
+   void polarDecomposition( const FixedMatrix<N>& A,
+                                  FixedMatrix<N>& Q,
+                                  FixedMatrix<N>& S,
+                                  double tolerance,
+                                  int maxIterations )
+   // factors A as A = QS with Q orthogonal and S symmetric
+   {
+      Q = A;
+
+      for( int iter = 0; iter < maxIterations; iter++ )
+      {
+         FixedMatrix<N> R = 0.5 * ( Q + Q.transpose().inverse() );
+         double change = ( R - Q ).norm();
+         Q = R;
+
+         if( change <= tolerance ) break;
+      }
+
+      S = Q.transpose() * A;
+   }
+
+   template <int N>
+   void svd( const FixedMatrix<N>& A,
+                   FixedMatrix<N>& U,
+                   FixedMatrix<N>& S,
+                   FixedMatrix<N>& V )
+   // factors A as A = USV^T using one-sided Jacobi rotations, which
+   // orthogonalize the columns of U = AV
+   {
+      const int maxSweeps = 30;
+      const double epsilon = 1e-15;
+
+      U = A;
+      V = FixedMatrix<N>::identity();
+
+      for( int sweep = 0; sweep < maxSweeps; sweep++ )
+      {
+         bool rotated = false;
+
+         for( int p = 0;   p < N; p++ )
+         for( int q = p+1; q < N; q++ )
+         {
+            double alpha = 0., beta = 0., gamma = 0.;
+            for( int i = 0; i < N; i++ )
+            {
+               alpha += U(i,p) * U(i,p);
+               beta  += U(i,q) * U(i,q);
+               gamma += U(i,p) * U(i,q);
+            }
+
+            if( fabs( gamma ) <= epsilon * sqrt( alpha * beta )) continue;
+            rotated = true;
+
+            // rotation that makes columns p and q orthogonal
+            double zeta = ( beta - alpha ) / ( 2. * gamma );
+            double t = ( zeta >= 0. ? 1. : -1. ) / ( fabs( zeta ) + sqrt( 1. + zeta*zeta ));
+            double c = 1. / sqrt( 1. + t*t );
+            double s = c * t;
+
+            for( int i = 0; i < N; i++ )
+            {
+               double up = U(i,p), uq = U(i,q);
+               U(i,p) = c*up - s*uq;
+               U(i,q) = s*up + c*uq;
+
+               double vp = V(i,p), vq = V(i,q);
+               V(i,p) = c*vp - s*vq;
+               V(i,q) = s*vp + c*vq;
+            }
+         }
+
+         if( !rotated ) break;
+      }
+
+      // the singular values are the column norms of AV
+      double sigma[N];
+      for( int j = 0; j < N; j++ )
+      {
+         double sum = 0.;
+         for( int i = 0; i < N; i++ ) sum += U(i,j) * U(i,j);
+         sigma[j] = sqrt( sum );
+      }
+
+      // sort in decreasing order
+      for( int j = 0; j < N; j++ )
+      {
+         int k = j;
+         for( int l = j+1; l < N; l++ )
+         {
+            if( sigma[l] > sigma[k] ) k = l;
+         }
+         if( k != j )
+         {
+            std::swap( sigma[j], sigma[k] );
+            for( int i = 0; i < N; i++ )
+            {
+               std::swap( U(i,j), U(i,k) );
+               std::swap( V(i,j), V(i,k) );
+            }
+         }
+      }
+
+      // normalize the columns of U; columns belonging to (numerically)
+      // zero singular values are completed to an orthonormal basis
+      S = FixedMatrix<N>();
+      for( int j = 0; j < N; j++ )
+      {
+         S(j,j) = sigma[j];
+
+         if( sigma[j] > epsilon * std::max( sigma[0], 1e-300 ))
+         {
+            for( int i = 0; i < N; i++ ) U(i,j) /= sigma[j];
+            continue;
+         }
+
+         // take the standard basis vector with the largest component
+         // orthogonal to the columns found so far
+         double best = -1.;
+         for( int e = 0; e < N; e++ )
+         {
+            double u[N];
+            for( int i = 0; i < N; i++ ) u[i] = ( i == e ? 1. : 0. );
+            for( int k = 0; k < j; k++ )
+            {
+               double d = U(e,k);
+               for( int i = 0; i < N; i++ ) u[i] -= d * U(i,k);
+            }
+
+            double sum = 0.;
+            for( int i = 0; i < N; i++ ) sum += u[i] * u[i];
+            if( sum > best )
+            {
+               best = sum;
+               for( int i = 0; i < N; i++ ) U(i,j) = u[i] / sqrt( sum );
+            }
+         }
+      }
+   }
+
+   template <int N>
+   std::ostream& operator<<( std::ostream& os, const FixedMatrix<N>& A )
+   // prints entries
+   {
+      for( int i = 0; i < N; i++ )
+      {
+         os << "[ ";
+         for( int j = 0; j < N; j++ )
+         {
+            os << A(i,j) << " ";
+         }
+         os << "]" << std::endl;
+      }
+
+      return os;
+   }
+}
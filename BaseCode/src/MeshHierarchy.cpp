@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <cassert>
+using namespace std;
+
+#include "MeshHierarchy.h"
+#include "Mesh.h"
+
+namespace DDG
+{
+   MeshHierarchy :: MeshHierarchy( void )
+   // constructs an empty hierarchy
+   {}
+
+   void MeshHierarchy :: build( const Mesh& mesh, int coarsestSize, int maxLevels )
+   // clusters the vertices of mesh until a level has no more than
+   // coarsestSize vertices (or maxLevels levels have been built)
+   {
+      levelSize.clear();
+      levelAggregates.clear();
+      levelCenters.clear();
+
+      Adjacency adjacency;
+      buildFinestLevel( mesh, adjacency );
+
+      while( (int) levelSize.size() < maxLevels &&
+             levelSize.back() > coarsestSize )
+      {
+         vector<int> agg;
+         int nCoarse = aggregate( adjacency, levelCenters.back(), agg );
+
+         // give up if clustering no longer reduces the problem size
+         if( nCoarse >= levelSize.back() )
+         {
+            break;
+         }
+
+         // cluster centers are the mean positions of their members
+         const vector<Vector>& fineCenters( levelCenters.back() );
+         vector<Vector> coarseCenters( nCoarse );
+         vector<int> count( nCoarse, 0 );
+         for( size_t i = 0; i < agg.size(); i++ )
+         {
+            coarseCenters[ agg[i] ] += fineCenters[i];
+            count[ agg[i] ]++;
+         }
+         for( int I = 0; I < nCoarse; I++ )
+         {
+            coarseCenters[I] /= (double) count[I];
+         }
+
+         Adjacency coarseAdjacency;
+         coarsen( adjacency, agg, nCoarse, coarseAdjacency );
+         adjacency.swap( coarseAdjacency );
+
+         levelAggregates.push_back( vector<int>() );
+         levelAggregates.back().swap( agg );
+         levelCenters.push_back( vector<Vector>() );
+         levelCenters.back().swap( coarseCenters );
+         levelSize.push_back( nCoarse );
+      }
+   }
+
+   int MeshHierarchy :: nLevels( void ) const
+   // returns the number of levels, including the finest (level 0)
+   {
+      return levelSize.size();
+   }
+
+   int MeshHierarchy :: size( int level ) const
+   // returns the number of vertices on the specified level
+   {
+      return levelSize[ level ];
+   }
+
+   const vector<int>& MeshHierarchy :: aggregates( int level ) const
+   // returns the map from vertices on the specified level to vertices
+   // on the next coarser level
+   {
+      assert( level+1 < nLevels() );
+      return levelAggregates[ level ];
+   }
+
+   const vector<Vector>& MeshHierarchy :: centers( int level ) const
+   // returns the cluster centers (mean vertex positions) on the specified level
+   {
+      return levelCenters[ level ];
+   }
+
+   void MeshHierarchy :: buildFinestLevel( const Mesh& mesh, Adjacency& adjacency )
+   // initializes level 0 from the vertices and edges of mesh
+   {
+      int nV = mesh.vertices.size();
+
+      adjacency.resize( nV );
+      levelCenters.push_back( vector<Vector>( nV ));
+      levelSize.push_back( nV );
+
+      for( VertexCIter v  = mesh.vertices.begin();
+                       v != mesh.vertices.end();
+                       v ++ )
+      {
+         int i = v->index;
+         levelCenters.back()[i] = v->position;
+
+         if( v->isIsolated() ) continue;
+
+         // visit the one-ring
+         HalfEdgeCIter he = v->he;
+         do
+         {
+            adjacency[i].push_back( he->flip->vertex->index );
+            he = he->flip->next;
+         }
+         while( he != v->he );
+      }
+   }
+
+   int MeshHierarchy :: aggregate( const Adjacency& adjacency,
+                                   const vector<Vector>& position,
+                                   vector<int>& agg ) const
+   // clusters the vertices of a single level; returns the number of clusters
+   {
+      int n = adjacency.size();
+      int nCoarse = 0;
+
+      agg.assign( n, -1 );
+
+      // pass 1: any vertex whose neighbors are all unassigned becomes
+      // the root of a new cluster containing its entire one-ring
+      for( int i = 0; i < n; i++ )
+      {
+         if( agg[i] != -1 ) continue;
+
+         bool free = true;
+         for( size_t k = 0; k < adjacency[i].size(); k++ )
+         {
+            if( agg[ adjacency[i][k] ] != -1 )
+            {
+               free = false;
+               break;
+            }
+         }
+         if( !free ) continue;
+
+         agg[i] = nCoarse;
+         for( size_t k = 0; k < adjacency[i].size(); k++ )
+         {
+            agg[ adjacency[i][k] ] = nCoarse;
+         }
+         nCoarse++;
+      }
+
+      // pass 2: attach each remaining vertex to the closest cluster
+      // among those formed in pass 1
+      vector<int> rootAgg( agg );
+      for( int i = 0; i < n; i++ )
+      {
+         if( rootAgg[i] != -1 ) continue;
+
+         double minDistance = 0.;
+         for( size_t k = 0; k < adjacency[i].size(); k++ )
+         {
+            int j = adjacency[i][k];
+            if( rootAgg[j] == -1 ) continue;
+
+            double d = ( position[i] - position[j] ).norm2();
+            if( agg[i] == -1 || d < minDistance )
+            {
+               agg[i] = rootAgg[j];
+               minDistance = d;
+            }
+         }
+      }
+
+      // pass 3: whatever is left (e.g., isolated vertices) becomes a cluster of its own
+      for( int i = 0; i < n; i++ )
+      {
+         if( agg[i] == -1 )
+         {
+            agg[i] = nCoarse;
+            nCoarse++;
+         }
+      }
+
+      return nCoarse;
+   }
+
+   void MeshHierarchy :: coarsen( const Adjacency& fine,
+                                  const vector<int>& agg,
+                                  int nCoarse,
+                                  Adjacency& coarse ) const
+   // builds the cluster adjacency of the next coarser level -- two clusters
+   // are adjacent if any of their members share an edge
+   {
+      coarse.clear();
+      coarse.resize( nCoarse );
+
+      for( size_t i = 0; i < fine.size(); i++ )
+      {
+         int I = agg[i];
+         for( size_t k = 0; k < fine[i].size(); k++ )
+         {
+            int J = agg[ fine[i][k] ];
+            if( I != J )
+            {
+               coarse[I].push_back( J );
+            }
+         }
+      }
+
+      for( int I = 0; I < nCoarse; I++ )
+      {
+         sort( coarse[I].begin(), coarse[I].end() );
+         coarse[I].erase( unique( coarse[I].begin(), coarse[I].end() ), coarse[I].end() );
+      }
+   }
+}
@@ -0,0 +1,96 @@
+#include <unistd.h>
+using namespace std;
+
+#include "SolverPlanner.h"
+#include "MeshHierarchy.h"
+
+namespace DDG
+{
+   SolverPlanner :: SolverPlanner( void )
+   // constructs a planner with default budgets
+   : memoryBudget( .5 * physicalMemory() ),
+     timeBudget( 0. ),
+     flopRate( 1e9 ),
+     hierarchy( NULL )
+   {}
+
+   SolverPlan SolverPlanner :: plan( cholmod_sparse* A, cholmod_factor* L, cholmod_common* common ) const
+   // chooses a strategy for the matrix A, given its symbolic factor L
+   {
+      double entrySize = ( A->xtype == CHOLMOD_COMPLEX ? 2 : 1 ) * sizeof( double );
+      double indexSize = sizeof( UF_long );
+
+      // the simplicial factor stores nnz(L) values and row indices; the
+      // supernodal factor stores dense supernodes (including explicit zeros)
+      double simplicialMemory = common->lnz * ( entrySize + indexSize );
+      double supernodalMemory = simplicialMemory;
+      if( L && L->is_super )
+      {
+         supernodalMemory = L->xsize * entrySize + L->ssize * indexSize;
+      }
+
+      SolverPlan p;
+      p.memory = supernodalMemory;
+      p.time = common->fl / flopRate;
+
+      bool timeFits = timeBudget <= 0. || p.time <= timeBudget;
+      if( L == NULL )
+      {
+         // symbolic analysis itself ran out of memory
+         timeFits = false;
+      }
+
+      if( timeFits && ( memoryBudget <= 0. || supernodalMemory <= memoryBudget ))
+      {
+         p.strategy = strategyCholesky;
+      }
+      else if( timeFits && ( memoryBudget <= 0. || simplicialMemory <= memoryBudget ))
+      {
+         p.strategy = strategyLDLT;
+      }
+      else
+      {
+         p.strategy = iterative( A->nrow );
+      }
+
+      return p;
+   }
+
+   SolverStrategy SolverPlanner :: iterative( int n ) const
+   // returns the iterative strategy used for an n x n matrix when no factorization fits
+   {
+      if( hierarchy && hierarchy->size( 0 ) == n )
+      {
+         return strategyMultigrid;
+      }
+
+      return strategyConjugateGradient;
+   }
+
+   const char* SolverPlanner :: name( SolverStrategy strategy )
+   // returns a human-readable name for a strategy
+   {
+      switch( strategy )
+      {
+         case strategyCholesky:          return "Cholesky";
+         case strategyLDLT:              return "LDL^T";
+         case strategyMultigrid:         return "multigrid";
+         case strategyConjugateGradient: return "conjugate gradients";
+         default:                        return "unknown";
+      }
+   }
+
+   double SolverPlanner :: physicalMemory( void )
+   // returns the size of the physical memory of the machine, in bytes
+   {
+      long pages = sysconf( _SC_PHYS_PAGES );
+      long pageSize = sysconf( _SC_PAGESIZE );
+
+      if( pages <= 0 || pageSize <= 0 )
+      {
+         return 0.; // unknown; treat as unlimited
+      }
+
+      return (double) pages * (double) pageSize;
+   }
+}
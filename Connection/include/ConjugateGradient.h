@@ -0,0 +1,99 @@
+// -----------------------------------------------------------------------------
+// libDDG -- ConjugateGradient.h
+// -----------------------------------------------------------------------------
+//
+// solveConjugateGradient is an iterative solver for positive-definite (real
+// symmetric or complex Hermitian) systems.  Unlike sparse Cholesky factorization
+// it needs no memory beyond the matrix itself and a few vectors, at the cost of
+// a running time that depends on the conditioning of the system.  It is used
+// by solvePositiveDefinite when a factorization would not fit into the memory
+// budget (see SolverPlanner.h), but may also be called directly:
+//
+//    SparseMatrix<Real> A;
+//    DenseMatrix<Real> x, b;
+//
+//    solveConjugateGradient( A, x, b );
+//
+// Any LinearOperator (such as a matrix-free MeshLaplacian) may be passed in
+// place of A.  If x already has the same size as b, it is used as the initial
+// guess.  The system is preconditioned by its diagonal (Jacobi preconditioning)
+// unless a different Preconditioner is given (see Preconditioner.h):
+//
+//    IncompleteCholesky<Real> M;
+//    M.build( A );
+//    solveConjugateGradient( A, M, x, b );
+//
+
+#ifndef DDG_CONJUGATEGRADIENT_H
+#define DDG_CONJUGATEGRADIENT_H
+
+#include "Types.h"
+#include "SparseMatrix.h"
+#include "DenseMatrix.h"
+#include "LinearOperator.h"
+#include "Preconditioner.h"
+#include "SolverStats.h"
+
+namespace DDG
+{
+   template <class T>
+   int solveConjugateGradient( SparseMatrix<T>& A,
+                                DenseMatrix<T>& x,
+                                DenseMatrix<T>& b,
+                               double tolerance = 1e-10,
+                               int maxIterations = 1000 );
+   // solves the positive definite sparse linear system Ax = b using preconditioned
+   // conjugate gradients; iteration stops once |b-Ax|_2 / |b|_2 falls below tolerance.
+   // Returns the largest number of iterations needed by any column of b
+
+   template <class T>
+   int solveConjugateGradient( SparseMatrix<T>& A,
+                               const Preconditioner<T>& M,
+                                DenseMatrix<T>& x,
+                                DenseMatrix<T>& b,
+                               double tolerance = 1e-10,
+                               int maxIterations = 1000 );
+   // solves the positive definite sparse linear system Ax = b using conjugate
+   // gradients preconditioned by M
+
+   template <class T>
+   int solveConjugateGradient( const LinearOperator<T>& A,
+                                      DenseMatrix<T>& x,
+                                      DenseMatrix<T>& b,
+                               double tolerance = 1e-10,
+                               int maxIterations = 1000 );
+   // solves the positive definite linear system Ax = b using preconditioned
+   // conjugate gradients, applying A only through its LinearOperator interface
+
+   template <class T>
+   int solveConjugateGradient( const LinearOperator<T>& A,
+                               const Preconditioner<T>& M,
+                                      DenseMatrix<T>& x,
+                                      DenseMatrix<T>& b,
+                               double tolerance = 1e-10,
+                               int maxIterations = 1000 );
+   // solves the positive definite linear system Ax = b using conjugate
+   // gradients preconditioned by M
+
+   template <class T>
+   void smallestEigPositiveDefinite( const LinearOperator<T>& A,
+                                            DenseMatrix<T>& x,
+                                            bool ignoreConstantVector = true );
+   // solves A x = lambda x for the smallest nonzero eigenvalue lambda
+   // A must be positive (semi-)definite; x is used as an initial guess
+
+   template <class T>
+   void conjugateGradient( const LinearOperator<T>& A,
+                           const Preconditioner<T>& M,
+                                  DenseMatrix<T>& x,
+                                  DenseMatrix<T>& b,
+                           double tolerance,
+                           int maxIterations,
+                           SolverStats& stats );
+   // same as solveConjugateGradient, but stores the statistics of the solve
+   // in stats instead of reporting them
+}
+
+#include "ConjugateGradient.inl"
+
+#endif
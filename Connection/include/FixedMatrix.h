@@ -0,0 +1,127 @@
+// -----------------------------------------------------------------------------
+// libDDG -- FixedMatrix.h
+// -----------------------------------------------------------------------------
+//
+// FixedMatrix represents a small real N by N matrix whose size is known at
+// compile time.  Unlike DenseMatrix, its entries live inside the object itself
+// (no heap allocation), and all loops have constant bounds, so per-element
+// kernels (one small matrix per face, say) can be written without allocating
+// memory and are easily unrolled and vectorized by the compiler.  The common
+// cases have their own names:
+//
+//    Mat2 A;   // 2x2, initialized to zero
+//    Mat3 B = Mat3::identity();
+//
+// Entries are accessed like those of a DenseMatrix, e.g., A(i,j) = 1.  Besides
+// the usual arithmetic, FixedMatrix provides the determinant, inverse, the
+// polar decomposition A = QS, and the singular value decomposition A = USV^T:
+//
+//    Mat2 Q, S;
+//    polarDecomposition( A, Q, S );
+//
+// Determinants and inverses of 2x2 and 3x3 matrices use closed-form
+// expressions; larger matrices use Gaussian elimination.
+//
+
+#ifndef DDG_FIXEDMATRIX_H
+#define DDG_FIXEDMATRIX_H
+
+#include <iostream>
+#include "Vector.h"
+
+namespace DDG
+{
+   template <int N>
+   class FixedMatrix
+   {
+      public:
+         static constexpr int size = N;
+         // number of rows (and columns)
+
+         FixedMatrix( void );
+         // initializes all entries to zero
+
+         static FixedMatrix<N> identity( void );
+         // returns the N x N identity matrix
+
+         double& operator()( int row, int col );
+         double  operator()( int row, int col ) const;
+         // access the specified entry (uses 0-based indexing)
+
+         FixedMatrix<N> operator+( const FixedMatrix<N>& B ) const;
+         // returns sum of this matrix with B
+
+         FixedMatrix<N> operator-( const FixedMatrix<N>& B ) const;
+         // returns difference of this matrix with B
+
+         FixedMatrix<N> operator*( const FixedMatrix<N>& B ) const;
+         // returns product of this matrix with B
+
+         FixedMatrix<N> operator*( double c ) const;
+         // returns this matrix times the scalar c
+
+         void operator+=( const FixedMatrix<N>& B );
+         // adds B to this matrix
+
+         void operator-=( const FixedMatrix<N>& B );
+         // subtracts B from this matrix
+
+         void operator*=( double c );
+         // multiplies this matrix by the scalar c
+
+         FixedMatrix<N> transpose( void ) const;
+         // returns the transpose of this matrix
+
+         double trace( void ) const;
+         // returns the sum of the diagonal entries
+
+         double norm( void ) const;
+         // returns the Frobenius norm
+
+         double determinant( void ) const;
+         // returns the determinant
+
+         FixedMatrix<N> inverse( void ) const;
+         // returns the inverse (the matrix must be nonsingular)
+
+      protected:
+         double entries[N][N];
+         // entries, indexed by row and then column
+   };
+
+   typedef FixedMatrix<2> Mat2;
+   typedef FixedMatrix<3> Mat3;
+
+   template <int N>
+   FixedMatrix<N> operator*( double c, const FixedMatrix<N>& A );
+   // left scalar multiplication
+
+   Vector operator*( const Mat3& A, const Vector& v );
+   // returns the product of a 3x3 matrix with a vector
+
+   template <int N>
+   void polarDecomposition( const FixedMatrix<N>& A,
+                                  FixedMatrix<N>& Q,
+                                  FixedMatrix<N>& S,
+                                  double tolerance = 1e-10,
+                                  int maxIterations = 50 );
+   // factors the nonsingular matrix A as A = QS, where Q is orthogonal and S
+   // is symmetric, by Newton iteration Q <- (Q + Q^-T)/2 starting from Q = A;
+   // iteration stops once Q changes by less than tolerance (Frobenius norm)
+
+   template <int N>
+   void svd( const FixedMatrix<N>& A,
+                   FixedMatrix<N>& U,
+                   FixedMatrix<N>& S,
+                   FixedMatrix<N>& V );
+   // factors A as A = USV^T, where U and V are orthogonal and S is diagonal
+   // with nonnegative entries in decreasing order (one-sided Jacobi method)
+
+   template <int N>
+   std::ostream& operator<<( std::ostream& os, const FixedMatrix<N>& A );
+   // prints entries
+}
+
+#include "FixedMatrix.inl"
+
+#endif
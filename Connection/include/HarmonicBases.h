@@ -4,7 +4,9 @@
 #include "Mesh.h"
 #include "Real.h"
 #include "DenseMatrix.h"
+#include "DenseView.h"
 #include "SparseMatrix.h"
+#include "BatchSolve.h"
 #include "DiscreteExteriorCalculus.h"
 
 namespace DDG
@@ -22,6 +24,8 @@ namespace DDG
          ExteriorDerivative0Form<Real>::build( mesh, d0 );
          div = d0.transpose() * star1;
          
+         // collect the generators that get a harmonic basis
+         std::vector<const Mesh::Generator*> cycles;
          bool skipBoundaryLoop = true;
          for(unsigned i = 0; i < mesh.generators.size(); ++i)
          {
@@ -32,24 +36,41 @@ namespace DDG
                continue;
             }
             
-            DenseMatrix<Real> w;
-            buildClosedPrimalOneForm(mesh, cycle, w);
-                        
-            DenseMatrix<Real> u;
-            DenseMatrix<Real> divw = div * w;
-            backsolvePositiveDefinite( mesh.L, u, divw );
-            
-            DenseMatrix<Real> h = star1*( w - (d0*u) );
-            storeHarmonicForm(h, mesh);
-          }
+            cycles.push_back( &cycle );
+         }
+         int nb = cycles.size();
+         if( nb == 0 ) return;
+         
+         // build the right-hand side for each generator in its own column
+         DenseMatrix<Real> w( mesh.edges.size(), nb );
+         for(int k = 0; k < nb; ++k)
+         {
+            buildClosedPrimalOneForm(mesh, *cycles[k], w.column(k));
+         }
+         
+         // the generators are independent, so solve for them in parallel,
+         // writing each solution straight into its column of u
+         DenseMatrix<Real> divw = div * w;
+         DenseMatrix<Real> u( mesh.vertices.size(), nb );
+         std::vector< SolveJob<Real> > jobs;
+         for(int k = 0; k < nb; ++k)
+         {
+            jobs.push_back( SolveJob<Real>( mesh.L, u.column(k), divw.column(k) ) );
+         }
+         solvePositiveDefinite( jobs );
+         
+         DenseMatrix<Real> h = star1*( w - (d0*u) );
+         for(int k = 0; k < nb; ++k)
+         {
+            storeHarmonicForm(h.column(k), mesh);
+         }
       }
       
    protected:
       void buildClosedPrimalOneForm(const Mesh& mesh,
                                     const Mesh::Generator& cycle,
-                                    DenseMatrix<Real>& oneform) const
+                                    DenseView<Real> oneform) const
       {
-         oneform = DenseMatrix<Real>( mesh.edges.size() );
          for(unsigned i = 0; i < cycle.size(); ++i)
          {
             double value = 1.0;
@@ -59,7 +80,7 @@ namespace DDG
          }
       }
       
-      void storeHarmonicForm(const DenseMatrix<Real>& oneform,
+      void storeHarmonicForm(DenseView<Real> oneform,
                              Mesh& mesh)
       {
          for(EdgeIter e = mesh.edges.begin();
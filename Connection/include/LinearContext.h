@@ -8,15 +8,46 @@
 // is shared by all instances of DenseMatrix, SparseMatrix, and LinearSystem.
 // In other words, you shouldn't have to instantiate LinearContext yourself
 // unless you're doing something really fancy!
+//
+// Since cholmod_common holds workspace and statistics that are modified by
+// every call into SuiteSparse, each thread gets its own cholmod_common, which
+// is created the first time the thread uses the context and released when the
+// thread exits.  Independent solves (different matrices, different right-hand
+// sides) may therefore run concurrently on separate threads; a single matrix or
+// factor must still not be modified by two threads at once.  The ordering
+// settings and the ordering cache are shared by all threads.  Statistics of the
+// most recent solve are likewise kept per thread (see SolverStats.h).
+//
+// The context also determines which fill-reducing ordering is used by sparse
+// factorizations, and remembers orderings that have already been computed (see
+// OrderingCache.h).  For instance, to compare the fill produced by METIS with
+// the default strategy one could write
+//
+//    extern LinearContext context;
+//    context.ordering = orderMETIS;
 // 
 
 #ifndef DDG_LINEARSOLVERCONTEXT
 #define DDG_LINEARSOLVERCONTEXT
 
 #include <cholmod.h>
+#include <pthread.h>
+#include <vector>
+#include "OrderingCache.h"
+#include "SolverStats.h"
+#include "SolverPlanner.h"
+#include "Random.h"
 
 namespace DDG
 {
+   enum ResidualCheck
+   {
+      residualNever,    // never compute residuals
+      residualAlways,   // compute the residual of every solve
+      residualSampled,  // compute the residual of every residualInterval-th solve (per thread)
+      residualDebug     // compute residuals only in debug builds (i.e., unless NDEBUG is defined)
+   };
+
    class LinearContext
    {
       public:
@@ -27,10 +58,91 @@ namespace DDG
          // destructor
 
          operator cholmod_common*( void );
-         // allows LinearContext to be treated as a cholmod_common*
+         // allows LinearContext to be treated as a cholmod_common*; returns
+         // the cholmod_common belonging to the calling thread
+
+         cholmod_factor* analyze( cholmod_sparse* A );
+         // computes the symbolic Cholesky factorization of the symmetric matrix A,
+         // using a cached fill-reducing ordering if one is available
+
+         int solve( int sys, cholmod_factor* L, cholmod_dense* B, cholmod_dense** X );
+         // solves a system with the factor L (see cholmod_l_solve2), reusing the
+         // calling thread's workspace; *X is overwritten in place if it already
+         // has the right size and type (otherwise it is freed and reallocated)
+
+         void orderColumns( cholmod_sparse* A, std::vector<UF_long>& perm );
+         // computes a fill-reducing column ordering for the LU factorization of
+         // the square matrix A (based on the pattern of A+A^T); perm is left
+         // empty if the ordering should be chosen by the LU solver itself
+
+         SolverStats& stats( void );
+         // returns the statistics of the most recent solve on the calling thread
+
+         void report( const SolverStats& s );
+         // records s as the calling thread's most recent statistics, and
+         // prints it to stdout if verbose is true (reports from different
+         // threads are printed one at a time)
+
+         bool verbose;
+         // whether solvers print their statistics to stdout (default: true)
+
+         bool checkResidual( void );
+         // returns true if the current solve should compute its residual
+
+         ResidualCheck residuals;
+         // when solvers compute residuals (default: residualDebug)
+
+         int residualInterval;
+         // sampling interval for residualSampled (default: 10)
+
+         int reductionThreads;
+         // threads used by long dense reductions such as norms and inner
+         // products (see Reduction.h); zero means one per processor, and
+         // one disables threading (default: 0); also used when filling
+         // matrices with random numbers
+
+         Random random;
+         // generator used by DenseMatrix::randomize(); reseed it (e.g.,
+         // context.random.seed( 1 )) to make randomized runs reproducible
+
+         SolverPlanner planner;
+         // chooses a strategy for solvePositiveDefinite based on memory and time budgets
+
+         OrderingMethod ordering;
+         // fill-reducing ordering used by all factorizations (default: orderAuto)
+
+         OrderingCache orderings;
+         // orderings computed so far, keyed by sparsity pattern
 
       protected:
-         cholmod_common context;
+         bool computeOrdering( cholmod_sparse* S, std::vector<UF_long>& perm, OrderingMethod& method );
+         // orders the symmetric matrix S using the current ordering method,
+         // and stores the method actually used (which differs if it fell
+         // back to AMD) in method
+
+         class ThreadState
+         {
+            public:
+               cholmod_common common;
+               SolverStats stats;
+               int nSolves;
+               cholmod_dense* Y;
+               cholmod_dense* E;
+               // workspace reused by solve()
+         };
+
+         ThreadState* state( void );
+         // returns the state of the calling thread, creating it if necessary
+
+         static void release( void* state );
+         // finishes and deletes a thread's state (called at thread exit)
+
+         pthread_key_t key;
+         // identifies the state of each thread
+
+         pthread_mutex_t printMutex;
+         // serializes printing of statistics, so that the reports of
+         // solves running on different threads are not interleaved
    };
 }
 
@@ -0,0 +1,83 @@
+// -----------------------------------------------------------------------------
+// libDDG -- LinearOperator.h
+// -----------------------------------------------------------------------------
+//
+// LinearOperator is an abstract square linear map, described only by how it
+// acts on vectors.  Iterative solvers (solveConjugateGradient) and eigenvalue
+// iterations (smallestEigPositiveDefinite) accept any LinearOperator, so that
+// operators need not be assembled into a SparseMatrix.  SparseOperator adapts
+// an assembled matrix to this interface; MeshLaplacian (see MeshLaplacian.h)
+// applies the cotan-Laplace operator directly on a mesh.  For example,
+//
+//    SparseMatrix<Real> A;
+//    DenseMatrix<Real> x, b;
+//
+//    SparseOperator<Real> op( A );
+//    solveConjugateGradient( op, x, b );
+//
+// All operators act on every column of x at once.
+//
+
+#ifndef DDG_LINEAROPERATOR_H
+#define DDG_LINEAROPERATOR_H
+
+#include <cholmod.h>
+#include "Types.h"
+#include "SparseMatrix.h"
+#include "DenseMatrix.h"
+
+namespace DDG
+{
+   template <class T>
+   class LinearOperator
+   {
+      public:
+         virtual ~LinearOperator( void );
+         // destructor
+
+         virtual int size( void ) const = 0;
+         // returns the number of rows (and columns) of the operator
+
+         virtual void apply( const DenseMatrix<T>& x, DenseMatrix<T>& y ) const = 0;
+         // computes y = Ax; x and y must be distinct
+
+         virtual void diagonal( DenseMatrix<T>& d ) const = 0;
+         // stores the diagonal of the operator in the column vector d
+   };
+
+   template <class T>
+   class SparseOperator : public LinearOperator<T>
+   {
+      public:
+         SparseOperator( SparseMatrix<T>& A );
+         // constructs an operator that applies a copy of the square matrix A
+
+         virtual ~SparseOperator( void );
+         // destructor
+
+         virtual int size( void ) const;
+         // returns the number of rows (and columns) of the operator
+
+         virtual void apply( const DenseMatrix<T>& x, DenseMatrix<T>& y ) const;
+         // computes y = Ax
+
+         virtual void diagonal( DenseMatrix<T>& d ) const;
+         // stores the diagonal of the operator in the column vector d
+
+         long nnz( void ) const;
+         // returns the number of stored nonzeros
+
+      protected:
+         cholmod_sparse* A;
+         // compressed copy of the matrix
+
+      private:
+         SparseOperator( const SparseOperator& );
+         const SparseOperator& operator=( const SparseOperator& );
+         // copying is not supported
+   };
+}
+
+#include "LinearOperator.inl"
+
+#endif
@@ -64,9 +64,16 @@ namespace DDG
       Mesh( const Mesh& mesh );
       // constructs a copy of mesh
       
+      Mesh( Mesh&& mesh );
+      // takes the elements of mesh without copying them
+      
       const Mesh& operator=( const Mesh& mesh );
       // copies mesh
       
+      const Mesh& operator=( Mesh&& mesh );
+      // takes the elements of mesh without copying them; iterators
+      // into mesh remain valid and now refer to this mesh
+      
       int read( const std::string& filename );
       // reads a mesh from a Wavefront OBJ file; return value is nonzero
       // only if there was an error
@@ -0,0 +1,162 @@
+// -----------------------------------------------------------------------------
+// libDDG -- Multigrid.h
+// -----------------------------------------------------------------------------
+//
+// Multigrid is an iterative solver for positive-definite systems whose rows
+// and columns correspond to the vertices of a mesh (e.g., the cotan-Laplace
+// operator, or a heat-flow operator star0 + t*Delta).  It is an alternative to
+// sparse Cholesky factorization that needs memory proportional to the size of
+// the mesh rather than to the fill of the factor, and is therefore useful for
+// very large meshes.  Typical usage is
+//
+//    Mesh mesh;
+//    SparseMatrix<Real> A;
+//    DenseMatrix<Real> x, b;
+//
+//    MeshHierarchy hierarchy;
+//    hierarchy.build( mesh );
+//
+//    Multigrid<Real> M;
+//    M.build( hierarchy, A );
+//    solvePositiveDefinite( M, x, b );
+//
+// The hierarchy only depends on the mesh, and can be reused for any number of
+// matrices; likewise, a Multigrid object can be reused for any number of
+// right-hand sides.  Prolongation from level l+1 to level l is the cluster
+// indicator of MeshHierarchy smoothed by one step of damped Jacobi, and
+// coarse-level operators are the corresponding Galerkin products P^H A P.  All
+// of these are formed directly in compressed-column form, and each level keeps
+// a single copy of its operator.  The coarsest level is factored with CHOLMOD;
+// should that factorization fail, the coarsest level is smoothed instead.
+// Each cycle uses symmetric Gauss-Seidel smoothing, hence a V-cycle is itself
+// a symmetric positive-definite operator.  By default the unknowns on each
+// level are relaxed in the order given by a coloring of the level's operator,
+// so that each color class is smoothed in parallel (see
+// MulticolorGaussSeidel.h).  Only real and complex entries are supported.
+//
+
+#ifndef DDG_MULTIGRID_H
+#define DDG_MULTIGRID_H
+
+#include <cholmod.h>
+#include <vector>
+#include "Types.h"
+#include "SparseMatrix.h"
+#include "DenseMatrix.h"
+#include "MeshHierarchy.h"
+#include "GraphColoring.h"
+#include "MulticolorGaussSeidel.h"
+#include "SolverStats.h"
+
+namespace DDG
+{
+   enum MultigridCycle
+   {
+      vCycle,
+      wCycle
+   };
+
+   template <class T>
+   class Multigrid
+   {
+      public:
+         Multigrid( void );
+         // constructs an empty solver
+
+         ~Multigrid( void );
+         // destructor
+
+         void build( const MeshHierarchy& hierarchy, SparseMatrix<T>& A );
+         // builds all coarse-level operators for the positive-definite matrix A,
+         // whose rows and columns correspond to the vertices on level 0 of hierarchy
+
+         void solve( DenseMatrix<T>& x, const DenseMatrix<T>& b );
+         // solves Ax = b; if x already has the same size as b it is used as
+         // an initial guess, otherwise iteration starts from zero
+
+         void solve( DenseMatrix<T>& x, const DenseMatrix<T>& b, SolverStats& stats );
+         // same as above, but stores (rather than reports) the statistics
+         // of the solve in stats
+
+         bool valid( void ) const;
+         // returns true if the solver has been built; false otherwise
+
+         int nLevels( void ) const;
+         // returns the number of levels in the hierarchy
+
+         MultigridCycle cycleType;
+         // recursion pattern (default: vCycle)
+
+         int nSmooth;
+         // number of pre- and post-smoothing sweeps per level (default: 2)
+
+         bool multicolor;
+         // whether smoothing sweeps visit unknowns by color, relaxing each color
+         // class in parallel, rather than in index order (default: true)
+
+         int maxIterations;
+         // maximum number of cycles per solve (default: 100)
+
+         double tolerance;
+         // iteration stops once |b-Ax|_2 / |b|_2 falls below this value (default: 1e-10)
+
+      protected:
+         void clear( void );
+         // releases all levels
+
+         cholmod_sparse* buildProlongation( const cholmod_sparse* A,
+                                            const std::vector<int>& agg,
+                                            int nCoarse ) const;
+         // returns the smoothed-aggregation prolongation for the operator A
+         // and the cluster map agg (to be freed by the caller)
+
+         cholmod_sparse* galerkinProduct( cholmod_sparse* A, cholmod_sparse* P ) const;
+         // returns the coarse-level operator P^H A P (to be freed by the caller)
+
+         void cycle( int level, DenseMatrix<T>& x, const DenseMatrix<T>& b );
+         // applies one cycle on the specified level
+
+         void smooth( int level, DenseMatrix<T>& x, const DenseMatrix<T>& b, bool forward ) const;
+         // applies one forward or backward Gauss-Seidel sweep
+
+         void residual( int level, const DenseMatrix<T>& x, const DenseMatrix<T>& b, DenseMatrix<T>& r ) const;
+         // computes r = b - Ax
+
+         void restriction( int level, const DenseMatrix<T>& r, DenseMatrix<T>& rc ) const;
+         // computes rc = P^H r
+
+         void prolongate( int level, const DenseMatrix<T>& xc, DenseMatrix<T>& x ) const;
+         // computes x += P xc
+
+         std::vector<cholmod_sparse*> operators;
+         // system matrix on each level (full compressed-column storage)
+
+         std::vector<cholmod_sparse*> prolongations;
+         // prolongation from level l+1 to level l
+
+         std::vector<GraphColoring> colorings;
+         // coloring of the operator on each level except the coarsest
+
+         SparseFactor<T> coarsest;
+         // Cholesky factor of the coarsest-level operator
+   };
+
+   template <class T>
+   void solvePositiveDefinite( Multigrid<T>& M,
+                               DenseMatrix<T>& x,
+                               DenseMatrix<T>& b );
+   // solves the positive definite sparse linear system Ax = b using geometric multigrid,
+   // where A is the matrix used to build M
+
+   template <class T>
+   void solvePositiveDefinite( const MeshHierarchy& hierarchy,
+                               SparseMatrix<T>& A,
+                               DenseMatrix<T>& x,
+                               DenseMatrix<T>& b );
+   // solves the positive definite sparse linear system Ax = b using geometric multigrid
+   // over the given hierarchy (builds a temporary Multigrid object)
+}
+
+#include "Multigrid.inl"
+
+#endif
@@ -0,0 +1,74 @@
+// -----------------------------------------------------------------------------
+// libDDG -- Random.h
+// -----------------------------------------------------------------------------
+//
+// Random generates a stream of pseudorandom numbers uniformly distributed in
+// [0,1), determined entirely by a seed.  It is a counter-based generator
+// (Philox4x32-10): the i-th number of the stream is computed directly from the
+// seed and the counter value i, without stepping through the numbers that come
+// before it.  Long arrays can therefore be filled by several threads at once,
+// each computing its own part of the stream, and the result is identical for
+// any number of threads.  For example,
+//
+//    Random rng( 42 );
+//    double u = rng.uniform();       // first number of stream 42
+//    rng.fill( x, n, -1., 1. );      // next n numbers, scaled to [-1,1)
+//
+// DenseMatrix::randomize() draws from the generator context.random (see
+// LinearContext.h), so reseeding it makes randomized initial guesses (e.g.,
+// for the eigenvalue solvers in SparseMatrix.h) reproducible.  Drawing is
+// thread-safe: each call to uniform() or fill() atomically reserves the next
+// range of counter values, so threads sharing a generator never receive the
+// same numbers (though which thread gets which range depends on timing; use
+// one generator per thread, each with its own seed, if that matters).  Only
+// seed() must not run concurrently with other calls on the same object.
+//
+
+#ifndef DDG_RANDOM_H
+#define DDG_RANDOM_H
+
+#include <atomic>
+
+namespace DDG
+{
+   class Random
+   {
+      public:
+         Random( unsigned long seed = 0 );
+         // constructs the stream of numbers determined by seed
+
+         Random( const Random& rng );
+         const Random& operator=( const Random& rng );
+         // copies the seed and position of rng
+
+         void seed( unsigned long seed );
+         // restarts the stream determined by seed from the beginning
+
+         unsigned long position( void ) const;
+         // returns the number of values drawn so far
+
+         double uniform( void );
+         // returns the next number in [0,1)
+
+         double uniform( double a, double b );
+         // returns the next number, scaled to [a,b)
+
+         void fill( double* x, long n, double a = 0., double b = 1., int nThreads = 0 );
+         // stores the next n numbers, scaled to [a,b), in x[0], ..., x[n-1];
+         // the optional argument nThreads gives the number of threads used
+         // for long arrays (zero means one per processor, and one disables
+         // threading), and does not affect the result
+
+         static double value( unsigned long seed, unsigned long index );
+         // returns number index of the stream determined by seed, in [0,1)
+
+      protected:
+         unsigned long key;
+         // seed of the stream
+
+         std::atomic<unsigned long> counter;
+         // index of the next number in the stream
+   };
+}
+
+#endif
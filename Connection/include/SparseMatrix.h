@@ -24,7 +24,13 @@
 // library.  In particular, dereferencing a SparseMatrix returns a
 // cholmod_sparse* which can be used by routines in SuiteSparse.  For basic
 // operations, however, you should not need to access this pointer explicitly --
-// see the solve() method below.
+// see the solve() method below.  To solve many systems with the same matrix
+// (e.g., several right-hand sides that only become available one batch at a
+// time), factor it once and reuse the factorization:
+//
+//    SparseQRFactor<Quaternion> QR;
+//    QR.build( A );
+//    backsolve( QR, x, b ); // each column of b is a right-hand side
 //
 // Internally SparseMatrix stores nonzero entries in a heap data structure; the
 // amortized cost of insertion is therefore no worse than the sorting cost of
@@ -35,8 +41,11 @@
 #define DDG_SPARSE_MATRIX_H
 
 #include <cholmod.h>
+#include <SuiteSparseQR.hpp>
+#include <pthread.h>
 #include <vector>
 #include <map>
+#include <string>
 #include "Types.h"
 
 namespace DDG
@@ -51,12 +60,18 @@ namespace DDG
          SparseMatrix( const SparseMatrix<T>& B );
          // copy constructor
 
+         SparseMatrix( SparseMatrix<T>&& B );
+         // move constructor; takes the entries of B, leaving B empty
+
          ~SparseMatrix( void );
          // destructor
 
          const SparseMatrix<T>& operator=( const SparseMatrix<T>& B );
          // copies B
 
+         const SparseMatrix<T>& operator=( SparseMatrix<T>&& B );
+         // takes the entries of B, leaving B empty
+
          const SparseMatrix<T>& operator=( cholmod_sparse* B );
          // copies a cholmod_sparse* into a SparseMatrix;
          // takes responsibility for deallocating B
@@ -74,7 +89,15 @@ namespace DDG
          // returns product of this matrix with sparse B
 
          DenseMatrix<T> operator*( const DenseMatrix<T>& B ) const;
-         // returns product of this matrix with dense B
+         // returns product of this matrix with dense B (see product())
+
+         void product( const T* x, int ldx, T* y, int ldy, int nColumns ) const;
+         // stores in y the product of this matrix with x, where x and y hold
+         // nColumns columns in column-major order with leading dimensions ldx
+         // and ldy; the product is computed on a compressed-column copy of
+         // the entries, which is kept from one product to the next and
+         // rebuilt only after the entries may have changed (i.e., after any
+         // non-const access to the matrix)
 
          void operator*=( const T& c );
          // multiplies this matrix by the scalar c
@@ -141,6 +164,10 @@ namespace DDG
          void shift( double c );
          // adds c times the identity matrix to this matrix
 
+         bool isHermitian( double relativeTolerance = 1e-12 ) const;
+         // returns true if this matrix equals its conjugate transpose (i.e., is
+         // symmetric, for real matrices), up to the given relative tolerance
+
       protected:
          int m, n;
          EntryMap data;
@@ -148,6 +175,20 @@ namespace DDG
 
          void allocateSparse( void );
          void setEntry( const_iterator e, int i, double* pr );
+
+         void compress( void ) const;
+         // brings the compressed-column copy used by product() up to date
+
+         mutable std::vector<UF_long> columnStart;
+         mutable std::vector<UF_long> rowIndex;
+         mutable std::vector<T> values;
+         // compressed-column copy of the entries, with values of type T
+
+         mutable bool compressed;
+         // whether the compressed-column copy matches the entries
+
+         mutable pthread_mutex_t compressMutex;
+         // serializes compress(), so that threads may share a const matrix
    };
 
    template <class T>
@@ -173,30 +214,155 @@ namespace DDG
          SparseFactor( void );
          ~SparseFactor( void );
 
+         SparseFactor( SparseFactor<T>&& F );
+         const SparseFactor<T>& operator=( SparseFactor<T>&& F );
+         // takes the factor of F, leaving F empty
+
          void build( SparseMatrix<T>& A );
          // factorizes positive-definite matrix A using CHOLMOD
 
+         void buildLDLT( SparseMatrix<T>& A );
+         // factorizes symmetric (quasi-definite) matrix A = LDL^T using
+         // CHOLMOD's simplicial LDL' factorization; no pivoting is performed,
+         // so factorization fails if a zero pivot is encountered.  Only the
+         // upper triangle of A is read, and complex matrices are taken to be
+         // Hermitian (A = A^H), not complex-symmetric (A = A^T)
+
+         int update( SparseMatrix<T>& C );
+         // modifies the factorization of A to that of A + CC^T, where C is a
+         // sparse n x k matrix of low rank k (real factors only); return
+         // value is nonzero only if there was an error
+
+         int downdate( SparseMatrix<T>& C );
+         // modifies the factorization of A to that of A - CC^T (real factors
+         // only); return value is nonzero if there was an error or if
+         // A - CC^T is not positive-definite, in which case the factor is
+         // no longer valid and must be rebuilt
+
+         int removeRow( int i );
+         // replaces row and column i of the factored matrix with the
+         // corresponding row and column of the identity, e.g., to pin
+         // degree of freedom i with a Dirichlet condition x_i = b_i
+         // (subsequent right-hand sides must then include -A_fi b_i);
+         // return value is nonzero only if there was an error
+
+         int addRow( int i, SparseMatrix<T>& A );
+         // restores row and column i of the factored matrix from column i of
+         // A, undoing removeRow (real factors only); return value is nonzero
+         // if there was an error or if the result is not positive-definite
+
          bool valid( void ) const;
-         // returns true if the factor has been built; false otherwise
+         // returns true if the factor has been built successfully; false otherwise
+
+         int write( const std::string& filename ) const;
+         // saves the factor to a binary file (see FactorIO.h); return value is
+         // nonzero only if there was an error, or if the factor has been
+         // modified since it was built
+
+         int read( const std::string& filename, SparseMatrix<T>& A );
+         // loads a factor saved by write(), provided it was computed from a
+         // matrix identical to A; return value is nonzero (and the current
+         // factor is left unchanged) if the file could not be used
+
+         static std::string filename( const std::string& meshFilename );
+         // returns the conventional factor file name for a mesh file
 
          cholmod_factor* to_cholmod( void );
          // returns pointer to underlying cholmod_factor data structure
 
       protected:
+         int updown( bool add, SparseMatrix<T>& C );
+         // computes the factorization of A + CC^T (update) or A - CC^T
+         // (downdate); return value is nonzero only if there was an error
+
+         bool prepareModify( void );
+         // converts the factor to simplicial LDL' form for modification
+
+         int permutedIndex( int i ) const;
+         // returns the row of PAP^T corresponding to row i of A (requires a
+         // preceding call to prepareModify())
+
          cholmod_factor *L;
+
+         unsigned long hash;
+         // hash of the factored matrix (see FactorIO::hash), or zero if
+         // the factor has been modified
+
+         std::vector<UF_long> inversePerm;
+         // inverse of the fill-reducing permutation L->Perm, built by
+         // prepareModify() (empty if the permutation is the identity or
+         // has not been needed yet)
+
+      private:
+         SparseFactor( const SparseFactor<T>& F );
+         const SparseFactor<T>& operator=( const SparseFactor<T>& F );
+         // copying is not supported
+   };
+
+   template <class T>
+   class SparseQRFactor
+   {
+      public:
+         SparseQRFactor( void );
+         ~SparseQRFactor( void );
+
+         SparseQRFactor( SparseQRFactor<T>&& F );
+         const SparseQRFactor<T>& operator=( SparseQRFactor<T>&& F );
+         // takes the factorization of F, leaving F empty
+
+         void build( SparseMatrix<T>& A );
+         // factorizes A = QR using SuiteSparseQR (real and quaternionic
+         // matrices only; quaternionic matrices are factored in their real
+         // 4m x 4n expansion, which is therefore built only once)
+
+         bool valid( void ) const;
+         // returns true if the factorization has been built successfully; false otherwise
+
+         int rank( void ) const;
+         // returns the estimated rank of the factored matrix
+
+         SuiteSparseQR_factorization<double>* to_cholmod( void );
+         // returns pointer to underlying SuiteSparseQR factorization
+
+      protected:
+         SuiteSparseQR_factorization<double>* QR;
+
+         int width;
+         // number of real rows (or columns) per entry of the factored matrix
+
+      private:
+         SparseQRFactor( const SparseQRFactor<T>& F );
+         const SparseQRFactor<T>& operator=( const SparseQRFactor<T>& F );
+         // copying is not supported
    };
 
    template <class T>
    void solve( SparseMatrix<T>& A,
                 DenseMatrix<T>& x,
                 DenseMatrix<T>& b );
-   // solves the sparse linear system Ax = b using sparse QR factorization
+   // solves the sparse linear system Ax = b using sparse QR factorization;
+   // each column of b is a separate right-hand side
+
+   template <class T>
+   void backsolve( SparseQRFactor<T>& QR,
+                   DenseMatrix<T>& x,
+                   DenseMatrix<T>& b );
+   // solves Ax = b (in the least-squares sense if A has more rows than
+   // columns) for every column of b, using the prefactored matrix A = QR
 
    template <class T>
    void solveSymmetric( SparseMatrix<T>& A,
                         DenseMatrix<T>& x,
                         DenseMatrix<T>& b );
-   // solves the sparse linear system Ax = b using sparse LU factorization
+   // solves the symmetric (for complex matrices, Hermitian) sparse linear system Ax = b
+   // using sparse LDL^T factorization; falls back to sparse LU factorization if A is not
+   // quasi-definite, or is not Hermitian (e.g., complex-symmetric matrices with A = A^T)
+
+   template <class T>
+   void solveLU( SparseMatrix<T>& A,
+                 DenseMatrix<T>& x,
+                 DenseMatrix<T>& b );
+   // solves the square sparse linear system Ax = b using sparse LU factorization
 
    template <class T>
    void solvePositiveDefinite( SparseMatrix<T>& A,
@@ -210,6 +376,51 @@ namespace DDG
                                     DenseMatrix<T>& b );
    // backsolves the prefactored positive definite sparse linear system LL'x = b
 
+   template <class T>
+   void backsolveSymmetric( SparseFactor<T>& L,
+                             DenseMatrix<T>& x,
+                             DenseMatrix<T>& b );
+   // backsolves the prefactored symmetric sparse linear system LDL'x = b
+
+   template <class T>
+   void backsolve( cholmod_factor* L,
+                   DenseMatrix<T>& x,
+                   DenseMatrix<T>& b );
+   void backsolve( cholmod_factor* L,
+                   DenseMatrix<Real>& x,
+                   DenseMatrix<Real>& b );
+   void backsolve( cholmod_factor* L,
+                   DenseMatrix<Complex>& x,
+                   DenseMatrix<Complex>& b );
+   // solves LL'x = b (or LDL'x = b) using the CHOLMOD factor L; real and
+   // complex solutions are written directly into x, so repeated solves into
+   // an x of the right size perform no allocation
+
+   template <class T>
+   void backsolvePositiveDefinite( SparseFactor<T>& L,
+                                   DenseView<T> x,
+                                   DenseView<T> b );
+   template <class T>
+   void backsolveSymmetric( SparseFactor<T>& L,
+                            DenseView<T> x,
+                            DenseView<T> b );
+   void backsolve( cholmod_factor* L,
+                   DenseView<Real> x,
+                   DenseView<Real> b );
+   void backsolve( cholmod_factor* L,
+                   DenseView<Complex> x,
+                   DenseView<Complex> b );
+   // same as above, but for views into larger matrices (see DenseView.h);
+   // x must already have the size of the solution, and contiguous views
+   // (such as single columns) are solved into without any copying
+
+   template <class T>
+   void multiply( const SparseMatrix<T>& A,
+                  DenseView<T> x,
+                  DenseView<T> y );
+   // computes y = Ax, writing the product directly into the entries viewed by y
+   // (x and y must not share any entries; see also SparseMatrix::product())
+
    template <class T>
    void smallestEig( SparseMatrix<T>& A,
                       DenseMatrix<T>& x,
@@ -253,6 +464,13 @@ namespace DDG
                     const  DenseMatrix<T>& b );
    // returns the max residual of the linear problem A x = b relative to the largest entry of the solution
 
+   template <class T>
+   double residual( cholmod_sparse* A,
+                    const DenseMatrix<T>& x,
+                    const DenseMatrix<T>& b );
+   // same as above, but evaluated directly on the compressed matrix A (which must store
+   // all nonzeros, regardless of A->stype) using a single work vector and no temporaries
+
    template <class T>
    double residual( const SparseMatrix<T>& A,
                     const  DenseMatrix<T>& x );
@@ -292,4 +510,8 @@ namespace DDG
 
 #include "SparseMatrix.inl"
 
+// alternative solvers used by solvePositiveDefinite (see SolverPlanner.h)
+#include "ConjugateGradient.h"
+#include "Multigrid.h"
+
 #endif
@@ -0,0 +1,90 @@
+#include <iostream>
+using namespace std;
+
+#include "BatchSolve.h"
+#include "LinearContext.h"
+#include "Utility.h"
+
+namespace DDG
+{
+   extern LinearContext context;
+
+   template <class T>
+   SolveJob<T> :: SolveJob( SparseMatrix<T>& A_, DenseMatrix<T>& x_, DenseMatrix<T>& b_ )
+   : time( 0. ),
+     A( &A_ ),
+     L( NULL ),
+     x( &x_ ),
+     b( &b_ )
+   {}
+
+   template <class T>
+   SolveJob<T> :: SolveJob( SparseFactor<T>& L_, DenseMatrix<T>& x_, DenseMatrix<T>& b_ )
+   : time( 0. ),
+     A( NULL ),
+     L( &L_ ),
+     x( &x_ ),
+     b( &b_ )
+   {}
+
+   template <class T>
+   SolveJob<T> :: SolveJob( SparseFactor<T>& L_, DenseView<T> x_, DenseView<T> b_ )
+   : time( 0. ),
+     A( NULL ),
+     L( &L_ ),
+     x( NULL ),
+     b( NULL ),
+     xView( x_ ),
+     bView( b_ )
+   {}
+
+   template <class T>
+   void SolveJob<T> :: run( void )
+   // performs the solve
+   {
+      double t0 = wallClock();
+      context.stats().clear();
+
+      if( L && x == NULL )
+      {
+         backsolvePositiveDefinite( *L, xView, bView );
+      }
+      else if( L )
+      {
+         backsolvePositiveDefinite( *L, *x, *b );
+      }
+      else
+      {
+         solvePositiveDefinite( *A, *x, *b );
+      }
+
+      time = wallClock() - t0;
+      stats = context.stats();
+   }
+
+   template <class T>
+   void solvePositiveDefinite( vector< SolveJob<T> >& jobs, int nThreads )
+   // runs all jobs in parallel and reports the time taken by each job
+   {
+      ThreadPool pool( nThreads );
+
+      vector<ThreadPool::Task*> tasks( jobs.size() );
+      for( size_t k = 0; k < jobs.size(); k++ )
+      {
+         tasks[k] = &jobs[k];
+      }
+
+      double t0 = wallClock();
+      pool.run( tasks );
+      double t1 = wallClock();
+
+      if( context.verbose )
+      {
+         for( size_t k = 0; k < jobs.size(); k++ )
+         {
+            cout << "[batch] job " << k << ": " << jobs[k].time << "s" << "\n";
+         }
+         cout << "[batch] time: " << t1-t0 << "s (" << jobs.size() << " jobs, " << pool.nThreads() << " threads)" << "\n";
+      }
+   }
+}
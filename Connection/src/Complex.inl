@@ -1,31 +1,30 @@
-#include "Complex.h"
 #include <iostream>
 #include <cmath>
 
-using namespace std;
+#include "Complex.h"
 
 namespace DDG
 {
-   Complex::Complex( double a, double b )
+   constexpr Complex::Complex( double a, double b )
    // constructs number a+bi
    : re( a ), im( b )
    {}
 
-   void Complex::operator+=( const Complex& z )
+   inline void Complex::operator+=( const Complex& z )
    // add z
    {
       re += z.re;
       im += z.im;
    }
 
-   void Complex::operator-=( const Complex& z )
+   inline void Complex::operator-=( const Complex& z )
    // subtract z
    {
       re -= z.re;
       im -= z.im;
    }
 
-   void Complex::operator*=( const Complex& z )
+   inline void Complex::operator*=( const Complex& z )
    // Complex multiply by z
    {
       double a = re;
@@ -37,74 +36,74 @@ namespace DDG
       im = a*d+b*c;
    }
 
-   void Complex::operator*=( double r )
+   inline void Complex::operator*=( double r )
    // scalar multiply by r
    {
       re *= r;
       im *= r;
    }
 
-   void Complex::operator/=( double r )
+   inline void Complex::operator/=( double r )
    // scalar divide by r
    {
       re /= r;
       im /= r;
    }
 
-   void Complex::operator/=( const Complex& z )
+   inline void Complex::operator/=( const Complex& z )
    // scalar divide by r
    {
       *this *= z.inv();
    }
 
-   Complex Complex::operator-( void ) const
+   constexpr Complex Complex::operator-( void ) const
    {
       return Complex( -re, -im );
    }
 
-   Complex Complex::conj( void ) const
+   constexpr Complex Complex::conj( void ) const
    // returns Complex conjugate
    {
       return Complex( re, -im );
    }
 
-   Complex Complex::inv( void ) const
+   inline Complex Complex::inv( void ) const
    // returns inverse
    {
       return this->conj() / this->norm2();
    }
 
-   double Complex::arg( void ) const
+   inline double Complex::arg( void ) const
    // returns argument
    {
-      return atan2( im, re );
+      return std::atan2( im, re );
    }
 
-   double Complex::norm( void ) const
+   inline double Complex::norm( void ) const
    // returns norm
    {
-      return sqrt( re*re + im*im );
+      return std::sqrt( re*re + im*im );
    }
 
-   double Complex::norm2( void ) const
+   constexpr double Complex::norm2( void ) const
    // returns norm squared
    {
       return re*re + im*im;
    }
 
-   Complex Complex::unit( void ) const
+   inline Complex Complex::unit( void ) const
    // returns complex number with unit norm and same modulus
    {
       return *this / this->norm();
    }
 
-   Complex Complex::exponential( void ) const
+   inline Complex Complex::exponential( void ) const
    // complex exponentiation
    {
-      return exp( re ) * Complex( cos( im ), sin( im ));
+      return std::exp( re ) * Complex( std::cos( im ), std::sin( im ));
    }
 
-   Complex operator+( const Complex& z1, const Complex& z2 )
+   inline Complex operator+( const Complex& z1, const Complex& z2 )
    // binary addition
    {
       Complex z = z1;
@@ -112,7 +111,7 @@ namespace DDG
       return z;
    }
 
-   Complex operator-( const Complex& z1, const Complex& z2 )
+   inline Complex operator-( const Complex& z1, const Complex& z2 )
    // binary subtraction
    {
       Complex z = z1;
@@ -120,7 +119,7 @@ namespace DDG
       return z;
    }
 
-   Complex operator*( const Complex& z1, const Complex& z2 )
+   inline Complex operator*( const Complex& z1, const Complex& z2 )
    // binary Complex multiplication
    {
       Complex z = z1;
@@ -128,7 +127,7 @@ namespace DDG
       return z;
    }
 
-   Complex operator*( const Complex& z, double r )
+   inline Complex operator*( const Complex& z, double r )
    // right scalar multiplication
    {
       Complex zr = z;
@@ -136,13 +135,13 @@ namespace DDG
       return zr;
    }
 
-   Complex operator*( double r, const Complex& z )
+   inline Complex operator*( double r, const Complex& z )
    // left scalar multiplication
    {
       return z*r;
    }
 
-   Complex operator/( const Complex& z, double r )
+   inline Complex operator/( const Complex& z, double r )
    // scalar division
    {
       Complex zr = z;
@@ -150,7 +149,7 @@ namespace DDG
       return zr;
    }
 
-   Complex operator/( const Complex& z1, const Complex& z2 )
+   inline Complex operator/( const Complex& z1, const Complex& z2 )
    // complex division
    {
       Complex z = z1;
@@ -158,17 +157,17 @@ namespace DDG
       return z;
    }
 
-   double dot( const Complex& z1, const Complex& z2 )
+   constexpr double dot( const Complex& z1, const Complex& z2 )
    {
       return z1.re*z2.re + z1.im*z2.im;
    }
 
-   double cross( const Complex& z1, const Complex& z2 )
+   constexpr double cross( const Complex& z1, const Complex& z2 )
    {
       return z1.re*z2.im - z1.im*z2.re;
    }
 
-   std::ostream& operator<<( std::ostream& os, const Complex& z )
+   inline std::ostream& operator<<( std::ostream& os, const Complex& z )
    // prints components
    {
       if( z.im > 0 )
@@ -0,0 +1,177 @@
+#include <cassert>
+#include <iostream>
+using namespace std;
+
+#include "ConstrainedSolver.h"
+#include "LinearContext.h"
+
+namespace DDG
+{
+   extern LinearContext context;
+
+   template <class T>
+   ConstrainedSolver<T> :: ConstrainedSolver( void )
+   : Afc( NULL )
+   {}
+
+   template <class T>
+   ConstrainedSolver<T> :: ~ConstrainedSolver( void )
+   // destructor
+   {
+      clear();
+   }
+
+   template <class T>
+   void ConstrainedSolver<T> :: clear( void )
+   // releases the coupling block
+   {
+      if( Afc )
+      {
+         cholmod_l_free_sparse( &Afc, context );
+         Afc = NULL;
+      }
+   }
+
+   template <class T>
+   bool ConstrainedSolver<T> :: valid( void ) const
+   // returns true if the reduced system was factored successfully; false otherwise
+   {
+      return Afc != NULL && ( freeUnknowns.empty() || factor.valid() );
+   }
+
+   template <class T>
+   int ConstrainedSolver<T> :: nFree( void ) const
+   // returns the number of free unknowns
+   {
+      return freeUnknowns.size();
+   }
+
+   template <class T>
+   int ConstrainedSolver<T> :: nConstrained( void ) const
+   // returns the number of constrained unknowns
+   {
+      return constrainedUnknowns.size();
+   }
+
+   template <class T>
+   void ConstrainedSolver<T> :: build( SparseMatrix<T>& A, const vector<int>& constrained )
+   // extracts and factors the free-free block of A
+   {
+      assert( A.nRows() == A.nColumns() );
+
+      clear();
+
+      int n = A.nRows();
+      int nC = constrained.size();
+
+      // the position of each constrained unknown in the list of values
+      vector<int> constrainedIndex( n, -1 );
+      for( int k = 0; k < nC; k++ )
+      {
+         assert( 0 <= constrained[k] && constrained[k] < n );
+         constrainedIndex[ constrained[k] ] = k;
+      }
+      constrainedUnknowns = constrained;
+
+      freeIndex.assign( n, -1 );
+      freeUnknowns.clear();
+      for( int i = 0; i < n; i++ )
+      {
+         if( constrainedIndex[i] == -1 )
+         {
+            freeIndex[i] = freeUnknowns.size();
+            freeUnknowns.push_back( i );
+         }
+      }
+      int nF = freeUnknowns.size();
+
+      // split A into the free-free and free-constrained blocks
+      SparseMatrix<T> Aff( nF, nF );
+      SparseMatrix<T> AfcMatrix( nF, nC );
+      for( typename SparseMatrix<T>::const_iterator e  = A.begin();
+                                                    e != A.end();
+                                                    e ++ )
+      {
+         int i = freeIndex[ e->first.second ];
+         if( i == -1 ) continue;
+
+         int j = e->first.first;
+         if( freeIndex[j] != -1 )
+         {
+            Aff( i, freeIndex[j] ) = e->second;
+         }
+         else
+         {
+            AfcMatrix( i, constrainedIndex[j] ) = e->second;
+         }
+      }
+
+      Afc = cholmod_l_copy_sparse( AfcMatrix.to_cholmod(), context );
+
+      if( nF > 0 )
+      {
+         factor.build( Aff );
+      }
+   }
+
+   template <class T>
+   void ConstrainedSolver<T> :: solve( DenseMatrix<T>& x,
+                                       const DenseMatrix<T>& b,
+                                       const DenseMatrix<T>& values )
+   // solves Ax = b subject to x(constrained[k]) = values(k)
+   {
+      assert( Afc != NULL );
+      assert( b.nRows() == (int) freeIndex.size() );
+      assert( values.nRows() == nConstrained() );
+      assert( values.nColumns() == b.nColumns() );
+
+      int nF = nFree();
+      int nC = nConstrained();
+      int nRHS = b.nColumns();
+
+      // reduced right-hand side b_f - A_fc x_c
+      DenseMatrix<T> bf( nF, nRHS );
+      for( int c = 0; c < nRHS; c++ )
+      {
+         for( int i = 0; i < nF; i++ )
+         {
+            bf( i, c ) = b( freeUnknowns[i], c );
+         }
+      }
+
+      const UF_long* Ap = (const UF_long*) Afc->p;
+      const UF_long* Ai = (const UF_long*) Afc->i;
+      const T*       Ax = (const T*)       Afc->x;
+      for( int c = 0; c < nRHS; c++ )
+      {
+         for( int j = 0; j < nC; j++ )
+         {
+            T xj = values( j, c );
+            for( UF_long p = Ap[j]; p < Ap[j+1]; p++ )
+            {
+               bf( Ai[p], c ) -= Ax[p] * xj;
+            }
+         }
+      }
+
+      DenseMatrix<T> xf;
+      if( nF > 0 )
+      {
+         backsolvePositiveDefinite( factor, xf, bf );
+      }
+
+      // scatter free and constrained values back into the full solution
+      x = DenseMatrix<T>( b.nRows(), nRHS );
+      for( int c = 0; c < nRHS; c++ )
+      {
+         for( int i = 0; i < nF; i++ )
+         {
+            x( freeUnknowns[i], c ) = xf( i, c );
+         }
+         for( int k = 0; k < nC; k++ )
+         {
+            x( constrainedUnknowns[k], c ) = values( k, c );
+         }
+      }
+   }
+}
@@ -0,0 +1,362 @@
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+using namespace std;
+
+#include "DomainDecomposition.h"
+#include "ConjugateGradient.h"
+#include "LinearContext.h"
+#include "SolverStats.h"
+
+namespace DDG
+{
+   extern LinearContext context;
+
+   template <class T>
+   class SubdomainFactorTask : public ThreadPool::Task
+   // factors the diagonal block of A belonging to one subdomain
+   {
+      public:
+         SubdomainFactorTask( cholmod_sparse* A_, const vector<UF_long>& rows_, cholmod_factor*& L_ )
+         : A( A_ ), rows( rows_ ), L( L_ )
+         {}
+
+         virtual void run( void )
+         {
+            UF_long m = rows.size();
+            UF_long* r = (UF_long*) &rows[0];
+            cholmod_sparse* S = cholmod_l_submatrix( A, r, m, r, m, true, true, context );
+            S->stype = 1;
+
+            L = context.analyze( S );
+            cholmod_l_factorize( S, L, context );
+
+            // the block is singular if, e.g., the overlap has grown the
+            // subdomain to cover a whole component of a pure Laplacian
+            if( L && L->minor < L->n )
+            {
+               cholmod_l_free_factor( &L, context );
+               L = NULL;
+            }
+
+            cholmod_l_free_sparse( &S, context );
+         }
+
+      protected:
+         cholmod_sparse* A;
+         const vector<UF_long>& rows;
+         cholmod_factor*& L;
+   };
+
+   template <class T>
+   class SubdomainSolveTask : public ThreadPool::Task
+   // solves the subdomain problem for the restriction of r to one subdomain
+   {
+      public:
+         SubdomainSolveTask( cholmod_factor* L_, const vector<UF_long>& rows_, const DenseMatrix<T>& r_, DenseMatrix<T>& z_ )
+         : L( L_ ), rows( rows_ ), r( r_ ), z( z_ )
+         {}
+
+         virtual void run( void )
+         {
+            int m = rows.size();
+            int nc = r.nColumns();
+
+            if( L == NULL )
+            {
+               // the block could not be factored (see DomainDecomposition::valid())
+               z = DenseMatrix<T>( m, nc );
+               return;
+            }
+
+            cholmod_dense* B = cholmod_l_allocate_dense( m, nc, m, L->xtype, context );
+            T* Bx = (T*) B->x;
+            for( int c = 0; c < nc; c++ )
+            for( int k = 0; k < m; k++ )
+            {
+               Bx[ k + m*c ] = r( rows[k], c );
+            }
+
+            cholmod_dense* X = cholmod_l_solve( CHOLMOD_A, L, B, context );
+            const T* Xx = (const T*) X->x;
+            z = DenseMatrix<T>( m, nc );
+            for( int c = 0; c < nc; c++ )
+            for( int k = 0; k < m; k++ )
+            {
+               z( k, c ) = Xx[ k + m*c ];
+            }
+
+            cholmod_l_free_dense( &B, context );
+            cholmod_l_free_dense( &X, context );
+         }
+
+      protected:
+         cholmod_factor* L;
+         const vector<UF_long>& rows;
+         const DenseMatrix<T>& r;
+         DenseMatrix<T>& z;
+   };
+
+   template <class T>
+   DomainDecomposition<T> :: DomainDecomposition( void )
+   : overlap( 1 ),
+     coarseCorrection( true ),
+     nThreads( 0 ),
+     coarse( NULL ),
+     nFailed( 0 )
+   {}
+
+   template <class T>
+   DomainDecomposition<T> :: ~DomainDecomposition( void )
+   // destructor
+   {
+      clear();
+   }
+
+   template <class T>
+   void DomainDecomposition<T> :: clear( void )
+   // releases all factors
+   {
+      for( size_t s = 0; s < factors.size(); s++ )
+      {
+         if( factors[s] )
+         {
+            cholmod_l_free_factor( &factors[s], context );
+         }
+      }
+      if( coarse )
+      {
+         cholmod_l_free_factor( &coarse, context );
+      }
+
+      factors.clear();
+      subdomains.clear();
+      parts.clear();
+      coarse = NULL;
+      nFailed = 0;
+   }
+
+   template <class T>
+   bool DomainDecomposition<T> :: valid( void ) const
+   // returns true if every subdomain block was factored successfully
+   {
+      return nFailed == 0;
+   }
+
+   template <class T>
+   int DomainDecomposition<T> :: nSubdomains( void ) const
+   // returns the number of subdomains
+   {
+      return subdomains.size();
+   }
+
+   template <class T>
+   void DomainDecomposition<T> :: build( SparseMatrix<T>& A, const MeshPartition& partition )
+   // factors the (overlapping) subdomain blocks of A and the coarse operator
+   {
+      assert( A.nRows() == A.nColumns() );
+      assert( A.nRows() == partition.size() );
+
+      clear();
+
+      Timer timer;
+      cholmod_sparse* Ac = A.to_cholmod();
+      const UF_long* Ap = (const UF_long*) Ac->p;
+      const UF_long* Ai = (const UF_long*) Ac->i;
+      const T*       Ax = (const T*)       Ac->x;
+      int n = Ac->ncol;
+      int nParts = partition.nParts();
+
+      // grow each (nonempty) subdomain by the given number of layers of neighbors
+      vector<int> mark( n, -1 );
+      for( int s = 0; s < nParts; s++ )
+      {
+         if( partition.offsets[s] == partition.offsets[s+1] ) continue;
+
+         int label = subdomains.size();
+         subdomains.push_back( vector<UF_long>() );
+         vector<UF_long>& rows( subdomains.back() );
+
+         for( int k = partition.offsets[s]; k < partition.offsets[s+1]; k++ )
+         {
+            rows.push_back( partition.members[k] );
+            mark[ partition.members[k] ] = label;
+         }
+
+         size_t begin = 0;
+         for( int layer = 0; layer < overlap; layer++ )
+         {
+            size_t end = rows.size();
+            for( size_t k = begin; k < end; k++ )
+            {
+               UF_long i = rows[k];
+               for( UF_long p = Ap[i]; p < Ap[i+1]; p++ )
+               {
+                  if( mark[ Ai[p] ] != label )
+                  {
+                     mark[ Ai[p] ] = label;
+                     rows.push_back( Ai[p] );
+                  }
+               }
+            }
+            begin = end;
+         }
+
+         sort( rows.begin(), rows.end() );
+      }
+
+      // factor all subdomain blocks in parallel
+      int nS = subdomains.size();
+      factors.assign( nS, (cholmod_factor*) NULL );
+      vector<ThreadPool::Task*> tasks;
+      for( int s = 0; s < nS; s++ )
+      {
+         tasks.push_back( new SubdomainFactorTask<T>( Ac, subdomains[s], factors[s] ));
+      }
+      ThreadPool pool( nThreads );
+      pool.run( tasks );
+      nFailed = 0;
+      for( int s = 0; s < nS; s++ )
+      {
+         delete tasks[s];
+
+         if( factors[s] == NULL )
+         {
+            nFailed++;
+         }
+      }
+      if( nFailed > 0 )
+      {
+         cerr << "Warning: DomainDecomposition could not factor " << nFailed << " of " << nS
+              << " subdomain blocks (singular or not positive-definite)" << endl;
+      }
+
+      // coarse operator R0 A R0^*, where row s of R0 is the indicator
+      // function of (non-overlapping) subdomain s
+      parts = partition.parts;
+      if( coarseCorrection && nParts > 1 )
+      {
+         SparseMatrix<T> A0( nParts, nParts );
+         for( int j = 0; j < n; j++ )
+         {
+            for( UF_long p = Ap[j]; p < Ap[j+1]; p++ )
+            {
+               A0( parts[ Ai[p] ], parts[j] ) += Ax[p];
+            }
+         }
+
+         cholmod_sparse* A0c = A0.to_cholmod();
+         A0c->stype = 1;
+         coarse = context.analyze( A0c );
+         if( coarse )
+         {
+            cholmod_l_factorize( A0c, coarse, context );
+         }
+
+         // the coarse operator is singular if A is (e.g., a pure Laplacian);
+         // the correction is then skipped (as it is if analysis failed)
+         if( coarse && coarse->minor < coarse->n )
+         {
+            cholmod_l_free_factor( &coarse, context );
+            coarse = NULL;
+         }
+      }
+
+      SolverStats stats;
+      stats.solver = "dd setup";
+      timer.stop( stats );
+      stats.nnzA = cholmod_l_nnz( Ac, context );
+      context.report( stats );
+      if( context.verbose )
+      {
+         cout << "[dd setup] subdomains: " << nS << " (overlap: " << overlap << ", coarse: " << ( coarse ? "yes" : "no" ) << ")" << "\n";
+      }
+   }
+
+   template <class T>
+   void DomainDecomposition<T> :: apply( const DenseMatrix<T>& r, DenseMatrix<T>& z ) const
+   // computes z = M^-1 r
+   {
+      int n = parts.size();
+      int nc = r.nColumns();
+      int nS = subdomains.size();
+      assert( r.nRows() == n );
+      assert( valid() );
+
+      // subdomain solves
+      vector< DenseMatrix<T> > local( nS );
+      vector<ThreadPool::Task*> tasks;
+      for( int s = 0; s < nS; s++ )
+      {
+         tasks.push_back( new SubdomainSolveTask<T>( factors[s], subdomains[s], r, local[s] ));
+      }
+      ThreadPool pool( nThreads );
+      pool.run( tasks );
+      for( int s = 0; s < nS; s++ )
+      {
+         delete tasks[s];
+      }
+
+      z = DenseMatrix<T>( n, nc );
+      for( int s = 0; s < nS; s++ )
+      {
+         const vector<UF_long>& rows( subdomains[s] );
+         for( int c = 0; c < nc; c++ )
+         for( size_t k = 0; k < rows.size(); k++ )
+         {
+            z( rows[k], c ) += local[s]( k, c );
+         }
+      }
+
+      // coarse correction
+      if( coarse )
+      {
+         int nParts = coarse->n;
+         cholmod_dense* B = cholmod_l_zeros( nParts, nc, coarse->xtype, context );
+         T* Bx = (T*) B->x;
+         for( int c = 0; c < nc; c++ )
+         for( int i = 0; i < n; i++ )
+         {
+            Bx[ parts[i] + nParts*c ] += r( i, c );
+         }
+
+         cholmod_dense* X = cholmod_l_solve( CHOLMOD_A, coarse, B, context );
+         const T* Xx = (const T*) X->x;
+         for( int c = 0; c < nc; c++ )
+         for( int i = 0; i < n; i++ )
+         {
+            z( i, c ) += Xx[ parts[i] + nParts*c ];
+         }
+
+         cholmod_l_free_dense( &B, context );
+         cholmod_l_free_dense( &X, context );
+      }
+   }
+
+   template <class T>
+   void solvePositiveDefinite( const MeshPartition& partition,
+                               SparseMatrix<T>& A,
+                               DenseMatrix<T>& x,
+                               DenseMatrix<T>& b )
+   // solves the positive definite sparse linear system Ax = b using conjugate
+   // gradients preconditioned by domain decomposition over the given partition
+   {
+      DomainDecomposition<T> M;
+      M.build( A, partition );
+
+      if( !M.valid() )
+      {
+         // a preconditioner with missing subdomain solves is not positive-definite
+         if( context.verbose )
+         {
+            cout << "[dd] subdomain factorization failed; using IC(0) instead" << "\n";
+         }
+         IncompleteCholesky<T> M0;
+         M0.build( A );
+         solveConjugateGradient( A, M0, x, b );
+         return;
+      }
+
+      solveConjugateGradient( A, M, x, b );
+   }
+}
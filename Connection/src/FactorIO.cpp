@@ -0,0 +1,259 @@
+#include <cstring>
+#include <fstream>
+#include <iostream>
+using namespace std;
+
+#include "FactorIO.h"
+
+namespace DDG
+{
+   const char factorFileMagic[] = "DDGFAC1";
+   // identifies (and versions) files written by FactorIO::write()
+
+   class FactorHeader
+   // fixed-size record at the start of each factor file
+   {
+      public:
+         long indexSize;
+         long valueSize;
+         unsigned long hash;
+         long n;
+         long minor;
+         long xtype;
+         long ordering;
+         long isLL;
+         long isSuper;
+         long isMonotonic;
+         long nzmax;
+         long nsuper;
+         long ssize;
+         long xsize;
+         long maxcsize;
+         long maxesize;
+   };
+
+   inline int entrySize( int xtype )
+   // returns the number of doubles per numerical entry
+   {
+      return xtype == CHOLMOD_COMPLEX ? 2 : 1;
+   }
+
+   inline void writeArray( ofstream& out, const void* data, long count, size_t size )
+   {
+      if( count > 0 )
+      {
+         out.write( (const char*) data, count * size );
+      }
+   }
+
+   inline void* readArray( ifstream& in, long count, size_t size, cholmod_common* common )
+   // allocates an array with CHOLMOD's allocator (so that it is released along
+   // with the factor) and fills it from the file
+   {
+      void* data = cholmod_l_malloc( count, size, common );
+      if( data && count > 0 )
+      {
+         in.read( (char*) data, count * size );
+      }
+      return data;
+   }
+
+   unsigned long FactorIO :: hash( cholmod_sparse* A )
+   // returns a hash of the size, symmetry type, pattern, and values of A
+   {
+      const UF_long* Ap = (const UF_long*) A->p;
+      const UF_long* Ai = (const UF_long*) A->i;
+      const unsigned char* Ax = (const unsigned char*) A->x;
+      UF_long n = A->ncol;
+      UF_long nnz = Ap[n];
+
+      // a pattern-only matrix has no values (and A->x may be NULL)
+      size_t nBytes = 0;
+      if( A->xtype != CHOLMOD_PATTERN )
+      {
+         nBytes = nnz * entrySize( A->xtype ) * sizeof( double );
+      }
+
+      // FNV-1a
+      const unsigned long prime = 16777619UL;
+      unsigned long h = 2166136261UL;
+      h = ( h ^ (unsigned long) A->nrow ) * prime;
+      h = ( h ^ (unsigned long) ( A->stype + 1 )) * prime;
+      h = ( h ^ (unsigned long) A->xtype ) * prime;
+      for( UF_long j = 0; j <= n; j++ )
+      {
+         h = ( h ^ (unsigned long) Ap[j] ) * prime;
+      }
+      for( UF_long k = 0; k < nnz; k++ )
+      {
+         h = ( h ^ (unsigned long) Ai[k] ) * prime;
+      }
+      for( size_t k = 0; k < nBytes; k++ )
+      {
+         h = ( h ^ (unsigned long) Ax[k] ) * prime;
+      }
+
+      return h;
+   }
+
+   int FactorIO :: write( const string& filename, const cholmod_factor* L, unsigned long hash )
+   // writes L and the hash of the factored matrix to the given file
+   {
+      if( L->xtype != CHOLMOD_REAL && L->xtype != CHOLMOD_COMPLEX )
+      {
+         cerr << "Error: only numerical real or complex factors can be written to " << filename << endl;
+         return 1;
+      }
+
+      ofstream out( filename.c_str(), ios::binary );
+
+      if( !out.is_open() )
+      {
+         cerr << "Error writing to factor file " << filename << endl;
+         return 1;
+      }
+
+      FactorHeader h;
+      memset( &h, 0, sizeof( h ));
+      h.indexSize   = sizeof( UF_long );
+      h.valueSize   = sizeof( double );
+      h.hash        = hash;
+      h.n           = L->n;
+      h.minor       = L->minor;
+      h.xtype       = L->xtype;
+      h.ordering    = L->ordering;
+      h.isLL        = L->is_ll;
+      h.isSuper     = L->is_super;
+      h.isMonotonic = L->is_monotonic;
+      h.nzmax       = L->nzmax;
+      h.nsuper      = L->nsuper;
+      h.ssize       = L->ssize;
+      h.xsize       = L->xsize;
+      h.maxcsize    = L->maxcsize;
+      h.maxesize    = L->maxesize;
+
+      out.write( factorFileMagic, sizeof( factorFileMagic ));
+      out.write( (const char*) &h, sizeof( h ));
+
+      long n = L->n;
+      size_t entry = entrySize( L->xtype ) * sizeof( double );
+      writeArray( out, L->Perm,     n, sizeof( UF_long ));
+      writeArray( out, L->ColCount, n, sizeof( UF_long ));
+
+      if( L->is_super )
+      {
+         long nsuper = L->nsuper;
+         writeArray( out, L->super, nsuper+1, sizeof( UF_long ));
+         writeArray( out, L->pi,    nsuper+1, sizeof( UF_long ));
+         writeArray( out, L->px,    nsuper+1, sizeof( UF_long ));
+         writeArray( out, L->s,     L->ssize, sizeof( UF_long ));
+         writeArray( out, L->x,     L->xsize, entry );
+      }
+      else
+      {
+         writeArray( out, L->p,    n+1,      sizeof( UF_long ));
+         writeArray( out, L->i,    L->nzmax, sizeof( UF_long ));
+         writeArray( out, L->x,    L->nzmax, entry );
+         writeArray( out, L->nz,   n,        sizeof( UF_long ));
+         writeArray( out, L->next, n+2,      sizeof( UF_long ));
+         writeArray( out, L->prev, n+2,      sizeof( UF_long ));
+      }
+
+      return out.good() ? 0 : 1;
+   }
+
+   cholmod_factor* FactorIO :: read( const string& filename, unsigned long hash, int xtype, cholmod_common* common )
+   // reads a factor from the given file, provided it was computed from a
+   // matrix with the given hash and entry type
+   {
+      ifstream in( filename.c_str(), ios::binary );
+
+      if( !in.is_open() )
+      {
+         cerr << "Error reading from factor file " << filename << endl;
+         return NULL;
+      }
+
+      char magic[ sizeof( factorFileMagic ) ];
+      FactorHeader h;
+      in.read( magic, sizeof( magic ));
+      in.read( (char*) &h, sizeof( h ));
+      if( !in || memcmp( magic, factorFileMagic, sizeof( magic )) != 0 ||
+          h.indexSize != (long) sizeof( UF_long ) || h.valueSize != (long) sizeof( double ) ||
+          h.n < 0 || h.nsuper < 0 || h.ssize < 0 || h.xsize < 0 || h.nzmax < 0 )
+      {
+         cerr << "Error: " << filename << " does not appear to be a valid factor file!" << endl;
+         return NULL;
+      }
+
+      if( h.hash != hash || h.xtype != xtype )
+      {
+         cerr << "Error: " << filename << " was computed from a different matrix!" << endl;
+         return NULL;
+      }
+
+      // cholmod_l_allocate_factor provides Perm and ColCount; all other
+      // arrays are allocated here with the sizes cholmod_l_free_factor expects
+      long n = h.n;
+      size_t entry = entrySize( h.xtype ) * sizeof( double );
+      cholmod_factor* L = cholmod_l_allocate_factor( n, common );
+      if( L == NULL )
+      {
+         return NULL;
+      }
+      if( n > 0 )
+      {
+         in.read( (char*) L->Perm,     n * sizeof( UF_long ));
+         in.read( (char*) L->ColCount, n * sizeof( UF_long ));
+      }
+
+      L->minor        = h.minor;
+      L->ordering     = h.ordering;
+      L->is_ll        = h.isLL;
+      L->is_super     = h.isSuper;
+      L->is_monotonic = h.isMonotonic;
+      L->xtype        = h.xtype;
+
+      if( h.isSuper )
+      {
+         L->nsuper   = h.nsuper;
+         L->ssize    = h.ssize;
+         L->xsize    = h.xsize;
+         L->maxcsize = h.maxcsize;
+         L->maxesize = h.maxesize;
+         L->super = readArray( in, h.nsuper+1, sizeof( UF_long ), common );
+         L->pi    = readArray( in, h.nsuper+1, sizeof( UF_long ), common );
+         L->px    = readArray( in, h.nsuper+1, sizeof( UF_long ), common );
+         L->s     = readArray( in, h.ssize,    sizeof( UF_long ), common );
+         L->x     = readArray( in, h.xsize,    entry,             common );
+      }
+      else
+      {
+         L->nzmax = h.nzmax;
+         L->p    = readArray( in, n+1,     sizeof( UF_long ), common );
+         L->i    = readArray( in, h.nzmax, sizeof( UF_long ), common );
+         L->x    = readArray( in, h.nzmax, entry,             common );
+         L->nz   = readArray( in, n,       sizeof( UF_long ), common );
+         L->next = readArray( in, n+2,     sizeof( UF_long ), common );
+         L->prev = readArray( in, n+2,     sizeof( UF_long ), common );
+      }
+
+      if( !in || common->status < CHOLMOD_OK )
+      {
+         cerr << "Error: factor file " << filename << " is truncated!" << endl;
+         cholmod_l_free_factor( &L, common );
+         return NULL;
+      }
+
+      // a corrupted file can still have the right length; make sure the
+      // arrays describe a valid factor before anyone solves with it
+      if( !cholmod_l_check_factor( L, common ))
+      {
+         cerr << "Error: factor file " << filename << " is corrupted!" << endl;
+         cholmod_l_free_factor( &L, common );
+         return NULL;
+      }
+
+      return L;
+   }
+}
@@ -0,0 +1,131 @@
+#include "GraphColoring.h"
+#include "Mesh.h"
+
+using namespace std;
+
+namespace DDG
+{
+   void GraphColoring :: build( const Mesh& mesh )
+   // colors the vertices of mesh
+   {
+      int nV = mesh.vertices.size();
+
+      // neighbor lists in compressed form
+      vector<int> adjacencyOffsets( nV+1, 0 );
+      for( EdgeCIter e  = mesh.edges.begin();
+                     e != mesh.edges.end();
+                     e ++ )
+      {
+         adjacencyOffsets[ e->he->vertex->index + 1 ]++;
+         adjacencyOffsets[ e->he->flip->vertex->index + 1 ]++;
+      }
+      for( int i = 0; i < nV; i++ )
+      {
+         adjacencyOffsets[i+1] += adjacencyOffsets[i];
+      }
+
+      vector<int> adjacency( adjacencyOffsets[nV] );
+      vector<int> next( adjacencyOffsets.begin(), adjacencyOffsets.end()-1 );
+      for( EdgeCIter e  = mesh.edges.begin();
+                     e != mesh.edges.end();
+                     e ++ )
+      {
+         int i = e->he->vertex->index;
+         int j = e->he->flip->vertex->index;
+         adjacency[ next[i]++ ] = j;
+         adjacency[ next[j]++ ] = i;
+      }
+
+      build( adjacencyOffsets, adjacency );
+   }
+
+   void GraphColoring :: build( const cholmod_sparse* A )
+   // colors the rows of the square matrix A
+   {
+      const UF_long* Ap = (const UF_long*) A->p;
+      const UF_long* Ai = (const UF_long*) A->i;
+      int n = A->ncol;
+
+      // since the pattern is symmetric, column j lists the neighbors of row j
+      vector<int> adjacencyOffsets( n+1, 0 );
+      vector<int> adjacency;
+      adjacency.reserve( Ap[n] );
+      for( int j = 0; j < n; j++ )
+      {
+         for( UF_long p = Ap[j]; p < Ap[j+1]; p++ )
+         {
+            if( Ai[p] != j )
+            {
+               adjacency.push_back( Ai[p] );
+            }
+         }
+         adjacencyOffsets[j+1] = adjacency.size();
+      }
+
+      build( adjacencyOffsets, adjacency );
+   }
+
+   void GraphColoring :: build( const vector<int>& adjacencyOffsets, const vector<int>& adjacency )
+   // greedily colors a graph given by neighbor lists, and groups vertices by color
+   {
+      int n = adjacencyOffsets.size() - 1;
+
+      // forbidden[c] == i if color c is already used by a neighbor of vertex i
+      vector<int> forbidden;
+      colors.assign( n, -1 );
+      int nC = 0;
+      for( int i = 0; i < n; i++ )
+      {
+         for( int k = adjacencyOffsets[i]; k < adjacencyOffsets[i+1]; k++ )
+         {
+            int c = colors[ adjacency[k] ];
+            if( c >= 0 )
+            {
+               forbidden[c] = i;
+            }
+         }
+
+         int c = 0;
+         while( c < nC && forbidden[c] == i )
+         {
+            c++;
+         }
+         if( c == nC )
+         {
+            forbidden.push_back( -1 );
+            nC++;
+         }
+         colors[i] = c;
+      }
+
+      // group vertices by color
+      offsets.assign( nC+1, 0 );
+      for( int i = 0; i < n; i++ )
+      {
+         offsets[ colors[i] + 1 ]++;
+      }
+      for( int c = 0; c < nC; c++ )
+      {
+         offsets[c+1] += offsets[c];
+      }
+
+      members.resize( n );
+      vector<int> next( offsets.begin(), offsets.end()-1 );
+      for( int i = 0; i < n; i++ )
+      {
+         members[ next[ colors[i] ]++ ] = i;
+      }
+   }
+
+   int GraphColoring :: nColors( void ) const
+   // returns the number of colors used
+   {
+      return offsets.empty() ? 0 : offsets.size() - 1;
+   }
+
+   int GraphColoring :: size( void ) const
+   // returns the number of vertices
+   {
+      return colors.size();
+   }
+}
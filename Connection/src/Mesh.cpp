@@ -1,5 +1,6 @@
 #include <map>
 #include <fstream>
+#include <utility>
 #include "Mesh.h"
 #include "MeshIO.h"
 #include "DiscreteExteriorCalculus.h"
@@ -22,6 +23,12 @@ namespace DDG
       *this = mesh;
    }
    
+   Mesh :: Mesh( Mesh&& mesh )
+   {
+      firstGeneratorIndex = 0;
+      *this = std::move( mesh );
+   }
+   
    class  HalfEdgeIterCompare { public: bool operator()( const  HalfEdgeIter& i, const  HalfEdgeIter& j ) const { return &*i < &*j; } };
    class HalfEdgeCIterCompare { public: bool operator()( const HalfEdgeCIter& i, const HalfEdgeCIter& j ) const { return &*i < &*j; } };
    class    VertexIterCompare { public: bool operator()( const    VertexIter& i, const    VertexIter& j ) const { return &*i < &*j; } };
@@ -74,6 +81,24 @@ namespace DDG
       return *this;
    }
    
+   const Mesh& Mesh :: operator=( Mesh&& mesh )
+   {
+      // moving a vector leaves its elements where they are, so the
+      // iterators stored in the elements remain valid
+      halfedges           = std::move( mesh.halfedges     );
+      vertices            = std::move( mesh.vertices      );
+      edges               = std::move( mesh.edges         );
+      faces               = std::move( mesh.faces         );
+      boundaries          = std::move( mesh.boundaries    );
+      inputFilename       = std::move( mesh.inputFilename );
+      L                   = std::move( mesh.L             );
+      generators          = std::move( mesh.generators    );
+      harmonicCoefs       = std::move( mesh.harmonicCoefs );
+      firstGeneratorIndex = mesh.firstGeneratorIndex;
+      
+      return *this;
+   }
+   
    int Mesh::read( const string& filename )
    {
       inputFilename = filename;
@@ -314,8 +339,15 @@ namespace DDG
       // make L positive-definite
       Delta += Real(1.0e-8)*star0;
       
-      // pre-factorize
-      this->L.build(Delta);
+      // pre-factorize, reusing the factor saved by a previous run if it
+      // was computed from the same Laplacian
+      string factorFile = SparseFactor<Real>::filename( inputFilename );
+      ifstream saved( factorFile.c_str() );
+      if( !saved.is_open() || this->L.read( factorFile, Delta ) != 0 )
+      {
+         this->L.build(Delta);
+         this->L.write( factorFile );
+      }
       
       // generators
       int t0 = clock();
@@ -0,0 +1,458 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <utility>
+using namespace std;
+
+#include "Preconditioner.h"
+#include "Utility.h"
+
+namespace DDG
+{
+   template <class T>
+   Preconditioner<T> :: ~Preconditioner( void )
+   // destructor
+   {}
+
+   template <class T>
+   void JacobiPreconditioner<T> :: build( const LinearOperator<T>& A )
+   // stores the inverse of the diagonal of A (nonpositive entries are replaced by one)
+   {
+      DenseMatrix<T> d;
+      A.diagonal( d );
+
+      int n = A.size();
+      invDiagonal.assign( n, 1. );
+      for( int i = 0; i < n; i++ )
+      {
+         if( realPart( d( i )) > 0. )
+         {
+            invDiagonal[i] = 1. / realPart( d( i ));
+         }
+      }
+   }
+
+   template <class T>
+   void JacobiPreconditioner<T> :: apply( const DenseMatrix<T>& r, DenseMatrix<T>& z ) const
+   // computes z = D^-1 r
+   {
+      int n = invDiagonal.size();
+      assert( r.nRows() == n );
+
+      z = r;
+      for( int c = 0; c < r.nColumns(); c++ )
+      {
+         for( int i = 0; i < n; i++ )
+         {
+            z( i, c ) *= invDiagonal[i];
+         }
+      }
+   }
+
+   template <class T>
+   IncompleteCholesky<T> :: ~IncompleteCholesky( void )
+   // destructor
+   {}
+
+   template <class T>
+   void IncompleteCholesky<T> :: build( SparseMatrix<T>& A )
+   // computes an incomplete factor LL^* ~ A with the pattern of the lower triangle of A
+   {
+      assert( A.nRows() == A.nColumns() );
+
+      cholmod_sparse* Ac = A.to_cholmod();
+      const UF_long* Ap = (const UF_long*) Ac->p;
+      const UF_long* Ai = (const UF_long*) Ac->i;
+      int n = Ac->ncol;
+
+      // the diagonal comes first, followed by the strictly lower entries of A
+      Lp.resize( n+1 );
+      Li.clear();
+      for( int j = 0; j < n; j++ )
+      {
+         Lp[j] = Li.size();
+         Li.push_back( j );
+         for( UF_long q = Ap[j]; q < Ap[j+1]; q++ )
+         {
+            if( Ai[q] > j )
+            {
+               Li.push_back( Ai[q] );
+            }
+         }
+      }
+      Lp[n] = Li.size();
+
+      factor( Ac );
+   }
+
+   template <class T>
+   void IncompleteCholesky<T> :: refactor( SparseMatrix<T>& A )
+   // recomputes the values of the factor, keeping the pattern found by build()
+   {
+      assert( A.nRows() == A.nColumns() );
+      assert( A.nRows() == (int) Lp.size() - 1 );
+
+      factor( A.to_cholmod() );
+   }
+
+   template <class T>
+   void IncompleteCholesky<T> :: factor( cholmod_sparse* A )
+   // computes the values of L on its current pattern
+   {
+      const UF_long* Ap = (const UF_long*) A->p;
+      const UF_long* Ai = (const UF_long*) A->i;
+      const T*       Ax = (const T*)       A->x;
+      int n = A->ncol;
+
+      // load the lower triangle of A into the pattern of L; pos[i]
+      // holds the position of row i in the current column (or -1)
+      vector<UF_long> pos( n, -1 );
+      vector<double> aDiagonal( n, 0. );
+      Lx.assign( Li.size(), T( 0. ));
+      for( int j = 0; j < n; j++ )
+      {
+         for( UF_long p = Lp[j]; p < Lp[j+1]; p++ ) pos[ Li[p] ] = p;
+
+         for( UF_long q = Ap[j]; q < Ap[j+1]; q++ )
+         {
+            UF_long i = Ai[q];
+            if( i >= j && pos[i] >= 0 )
+            {
+               Lx[ pos[i] ] += Ax[q];
+            }
+         }
+         aDiagonal[j] = realPart( Lx[ Lp[j] ] );
+
+         for( UF_long p = Lp[j]; p < Lp[j+1]; p++ ) pos[ Li[p] ] = -1;
+      }
+
+      // right-looking factorization, discarding updates outside the pattern
+      for( int k = 0; k < n; k++ )
+      {
+         double d = realPart( Lx[ Lp[k] ] );
+         if( d <= 0. )
+         {
+            d = aDiagonal[k] > 0. ? aDiagonal[k] : 1.;
+         }
+         double lkk = sqrt( d );
+
+         Lx[ Lp[k] ] = lkk;
+         for( UF_long p = Lp[k]+1; p < Lp[k+1]; p++ )
+         {
+            Lx[p] /= lkk;
+         }
+
+         for( UF_long p = Lp[k]+1; p < Lp[k+1]; p++ )
+         {
+            int j = Li[p];
+            T ljk = Lx[p].conj();
+
+            for( UF_long q = Lp[j]; q < Lp[j+1]; q++ ) pos[ Li[q] ] = q;
+
+            for( UF_long r = p; r < Lp[k+1]; r++ )
+            {
+               if( pos[ Li[r] ] >= 0 )
+               {
+                  Lx[ pos[ Li[r] ] ] -= Lx[r] * ljk;
+               }
+            }
+
+            for( UF_long q = Lp[j]; q < Lp[j+1]; q++ ) pos[ Li[q] ] = -1;
+         }
+      }
+   }
+
+   template <class T>
+   void IncompleteCholesky<T> :: apply( const DenseMatrix<T>& r, DenseMatrix<T>& z ) const
+   // computes z = (LL^*)^-1 r
+   {
+      int n = Lp.size() - 1;
+      assert( r.nRows() == n );
+
+      z = r;
+      for( int c = 0; c < r.nColumns(); c++ )
+      {
+         // solve Ly = r
+         for( int j = 0; j < n; j++ )
+         {
+            T yj = z( j, c ) / Lx[ Lp[j] ];
+            z( j, c ) = yj;
+            for( UF_long p = Lp[j]+1; p < Lp[j+1]; p++ )
+            {
+               z( Li[p], c ) -= Lx[p] * yj;
+            }
+         }
+
+         // solve L^* z = y
+         for( int j = n-1; j >= 0; j-- )
+         {
+            T zj = z( j, c );
+            for( UF_long p = Lp[j]+1; p < Lp[j+1]; p++ )
+            {
+               zj -= Lx[p].conj() * z( Li[p], c );
+            }
+            z( j, c ) = zj / Lx[ Lp[j] ];
+         }
+      }
+   }
+
+   template <class T>
+   long IncompleteCholesky<T> :: nnz( void ) const
+   // returns the number of nonzeros in L
+   {
+      return Li.size();
+   }
+
+   template <class T>
+   IncompleteCholeskyThreshold<T> :: IncompleteCholeskyThreshold( double dropTolerance_, int fill_ )
+   : dropTolerance( dropTolerance_ ),
+     fill( fill_ )
+   {}
+
+   template <class T>
+   void IncompleteCholeskyThreshold<T> :: build( SparseMatrix<T>& A )
+   // computes an incomplete factor LL^* ~ A, choosing its pattern by magnitude
+   {
+      assert( A.nRows() == A.nColumns() );
+
+      vector<UF_long>& Lp( this->Lp );
+      vector<UF_long>& Li( this->Li );
+      vector<T>&       Lx( this->Lx );
+
+      cholmod_sparse* Ac = A.to_cholmod();
+      const UF_long* Ap = (const UF_long*) Ac->p;
+      const UF_long* Ai = (const UF_long*) Ac->i;
+      const T*       Ax = (const T*)       Ac->x;
+      int n = Ac->ncol;
+
+      Lp.assign( 1, 0 );
+      Li.clear();
+      Lx.clear();
+
+      // left-looking factorization: the columns k < j with L_jk != 0 are
+      // found through linked lists, where head[i] lists all columns whose
+      // next unused entry (at position next[k]) lies in row i
+      vector<UF_long> head( n, -1 ), link( n, -1 ), next( n, 0 );
+      vector<int> mark( n, -1 );
+      vector<T> w( n );
+      vector<UF_long> rows;
+      vector< pair<double,UF_long> > kept;
+
+      for( int j = 0; j < n; j++ )
+      {
+         // w = lower part of column j of A
+         rows.clear();
+         mark[j] = j; w[j] = 0.;
+         double aDiagonal = 0.;
+         double columnNorm2 = 0.;
+         int nA = 0;
+         for( UF_long q = Ap[j]; q < Ap[j+1]; q++ )
+         {
+            UF_long i = Ai[q];
+            if( i < j ) continue;
+            if( mark[i] != j ) { mark[i] = j; w[i] = 0.; rows.push_back( i ); }
+            w[i] += Ax[q];
+            columnNorm2 += Ax[q].norm2();
+            if( i == j ) aDiagonal += realPart( Ax[q] ); else nA++;
+         }
+
+         // w -= L(j:n,k) L_jk^* for every previous column k with L_jk != 0
+         for( UF_long k = head[j]; k != -1; )
+         {
+            UF_long nextColumn = link[k];
+            UF_long p = next[k];
+            T ljk = Lx[p].conj();
+
+            for( UF_long r = p; r < Lp[k+1]; r++ )
+            {
+               UF_long i = Li[r];
+               if( mark[i] != j ) { mark[i] = j; w[i] = 0.; rows.push_back( i ); }
+               w[i] -= Lx[r] * ljk;
+            }
+
+            // move column k to the list of its next row
+            next[k] = p+1;
+            if( next[k] < Lp[k+1] )
+            {
+               UF_long i = Li[ next[k] ];
+               link[k] = head[i];
+               head[i] = k;
+            }
+
+            k = nextColumn;
+         }
+
+         // pivot
+         double d = realPart( w[j] );
+         if( d <= 0. )
+         {
+            d = aDiagonal > 0. ? aDiagonal : 1.;
+         }
+         double ljj = sqrt( d );
+
+         // drop small entries, then keep only the largest ones
+         double threshold = dropTolerance * sqrt( columnNorm2 );
+         kept.clear();
+         for( size_t r = 0; r < rows.size(); r++ )
+         {
+            UF_long i = rows[r];
+            double magnitude = w[i].norm();
+            if( i != j && magnitude > threshold )
+            {
+               kept.push_back( make_pair( magnitude, i ));
+            }
+         }
+         size_t maxEntries = max( 1, fill*nA );
+         if( kept.size() > maxEntries )
+         {
+            nth_element( kept.begin(), kept.begin() + maxEntries, kept.end(), greater< pair<double,UF_long> >() );
+            kept.resize( maxEntries );
+         }
+
+         // store the column, with rows in increasing order
+         rows.clear();
+         for( size_t r = 0; r < kept.size(); r++ )
+         {
+            rows.push_back( kept[r].second );
+         }
+         sort( rows.begin(), rows.end() );
+
+         Li.push_back( j );
+         Lx.push_back( ljj );
+         for( size_t r = 0; r < rows.size(); r++ )
+         {
+            Li.push_back( rows[r] );
+            Lx.push_back( w[ rows[r] ] / ljj );
+         }
+         Lp.push_back( Li.size() );
+
+         if( !rows.empty() )
+         {
+            next[j] = Lp[j]+1;
+            link[j] = head[ rows[0] ];
+            head[ rows[0] ] = j;
+         }
+      }
+   }
+
+   template <class T>
+   SSORPreconditioner<T> :: SSORPreconditioner( double omega_ )
+   : omega( omega_ )
+   {}
+
+   template <class T>
+   void SSORPreconditioner<T> :: build( SparseMatrix<T>& A )
+   // stores the diagonal and strictly lower triangle of A
+   {
+      assert( A.nRows() == A.nColumns() );
+
+      cholmod_sparse* Ac = A.to_cholmod();
+      const UF_long* Bp = (const UF_long*) Ac->p;
+      const UF_long* Bi = (const UF_long*) Ac->i;
+      const T*       Bx = (const T*)       Ac->x;
+      int n = Ac->ncol;
+
+      diagonal.assign( n, 0. );
+      Ap.resize( n+1 );
+      Ai.clear();
+      Ax.clear();
+      for( int j = 0; j < n; j++ )
+      {
+         Ap[j] = Ai.size();
+         for( UF_long q = Bp[j]; q < Bp[j+1]; q++ )
+         {
+            if( Bi[q] == j )
+            {
+               diagonal[j] += realPart( Bx[q] );
+            }
+            else if( Bi[q] > j )
+            {
+               Ai.push_back( Bi[q] );
+               Ax.push_back( Bx[q] );
+            }
+         }
+         if( diagonal[j] <= 0. )
+         {
+            diagonal[j] = 1.;
+         }
+      }
+      Ap[n] = Ai.size();
+   }
+
+   template <class T>
+   void SSORPreconditioner<T> :: refactor( SparseMatrix<T>& A )
+   // reloads the values of A, keeping the pattern found by build()
+   {
+      assert( A.nRows() == A.nColumns() );
+      assert( A.nRows() == (int) Ap.size() - 1 );
+
+      cholmod_sparse* Ac = A.to_cholmod();
+      const UF_long* Bp = (const UF_long*) Ac->p;
+      const UF_long* Bi = (const UF_long*) Ac->i;
+      const T*       Bx = (const T*)       Ac->x;
+      int n = Ac->ncol;
+
+      for( int j = 0; j < n; j++ )
+      {
+         UF_long p = Ap[j];
+         double d = 0.;
+         for( UF_long q = Bp[j]; q < Bp[j+1]; q++ )
+         {
+            if( Bi[q] == j )
+            {
+               d += realPart( Bx[q] );
+            }
+            else if( Bi[q] > j )
+            {
+               // entries of the pattern are visited in the same order as in build()
+               if( p == Ap[j+1] || Ai[p] != Bi[q] )
+               {
+                  build( A );
+                  return;
+               }
+               Ax[p++] = Bx[q];
+            }
+         }
+         diagonal[j] = d > 0. ? d : 1.;
+      }
+   }
+
+   template <class T>
+   void SSORPreconditioner<T> :: apply( const DenseMatrix<T>& r, DenseMatrix<T>& z ) const
+   // computes z = M^-1 r with M = (D + wL) D^-1 (D + wL^*) / (w(2-w))
+   {
+      int n = diagonal.size();
+      assert( r.nRows() == n );
+
+      z = r;
+      for( int c = 0; c < r.nColumns(); c++ )
+      {
+         // solve (D + wL) y = r, then multiply by D
+         for( int j = 0; j < n; j++ )
+         {
+            T yj = z( j, c ) / diagonal[j];
+            for( UF_long p = Ap[j]; p < Ap[j+1]; p++ )
+            {
+               z( Ai[p], c ) -= omega * Ax[p] * yj;
+            }
+            z( j, c ) = yj * diagonal[j];
+         }
+
+         // solve (D + wL^*) z = y, and scale by w(2-w)
+         for( int j = n-1; j >= 0; j-- )
+         {
+            T zj = z( j, c );
+            for( UF_long p = Ap[j]; p < Ap[j+1]; p++ )
+            {
+               zj -= omega * Ax[p].conj() * z( Ai[p], c );
+            }
+            z( j, c ) = zj / diagonal[j];
+         }
+         for( int j = 0; j < n; j++ )
+         {
+            z( j, c ) *= omega * ( 2. - omega );
+         }
+      }
+   }
+}
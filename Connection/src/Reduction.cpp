@@ -0,0 +1,644 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+using namespace std;
+
+#include "Reduction.h"
+#include "ThreadPool.h"
+
+namespace DDG
+{
+   const long reductionBlockSize = 16384;
+   // number of entries per block; block boundaries (and hence the order in
+   // which values are added) depend only on the length of the array
+
+   const long parallelReductionSize = 1048576;
+   // arrays with fewer entries than this are reduced on the calling thread
+
+   const int reductionLanes = 8;
+   // number of independent accumulators per block (enough to fill one AVX-512
+   // register, or two AVX registers, with doubles)
+
+   inline double sumLanes( const double* s )
+   // adds up the accumulators of one block in a fixed order
+   {
+      return ( ( s[0] + s[1] ) + ( s[2] + s[3] ) ) +
+             ( ( s[4] + s[5] ) + ( s[6] + s[7] ) );
+   }
+
+   inline double maxLanes( const double* s )
+   // returns the largest accumulator of one block
+   {
+      double r = s[0];
+      for( int k = 1; k < reductionLanes; k++ )
+      {
+         r = max( r, s[k] );
+      }
+      return r;
+   }
+
+   // Each kernel reduces the entries begin through end-1 of its arrays into
+   // r[0] (or, for kernels with several results, r[0], r[1], ...);
+   // Kernel::maximum says whether the results of different blocks are
+   // combined by taking the maximum rather than the sum.
+
+   class SumKernel
+   {
+      public:
+         SumKernel( const double* x_ )
+         : x( x_ )
+         {}
+
+         static const bool maximum = false;
+         const double* x;
+
+         void operator()( long begin, long end, double* r ) const
+         {
+            double s[ reductionLanes ] = { 0. };
+            long i = begin;
+            for( ; i + reductionLanes <= end; i += reductionLanes )
+            for( int k = 0; k < reductionLanes; k++ )
+            {
+               s[k] += x[i+k];
+            }
+            for( ; i < end; i++ )
+            {
+               s[0] += x[i];
+            }
+            r[0] = sumLanes( s );
+         }
+   };
+
+   class SumAbsKernel
+   {
+      public:
+         SumAbsKernel( const double* x_ )
+         : x( x_ )
+         {}
+
+         static const bool maximum = false;
+         const double* x;
+
+         void operator()( long begin, long end, double* r ) const
+         {
+            double s[ reductionLanes ] = { 0. };
+            long i = begin;
+            for( ; i + reductionLanes <= end; i += reductionLanes )
+            for( int k = 0; k < reductionLanes; k++ )
+            {
+               s[k] += fabs( x[i+k] );
+            }
+            for( ; i < end; i++ )
+            {
+               s[0] += fabs( x[i] );
+            }
+            r[0] = sumLanes( s );
+         }
+   };
+
+   class MaxAbsKernel
+   {
+      public:
+         MaxAbsKernel( const double* x_ )
+         : x( x_ )
+         {}
+
+         static const bool maximum = true;
+         const double* x;
+
+         void operator()( long begin, long end, double* r ) const
+         {
+            double s[ reductionLanes ] = { 0. };
+            long i = begin;
+            for( ; i + reductionLanes <= end; i += reductionLanes )
+            for( int k = 0; k < reductionLanes; k++ )
+            {
+               double a = fabs( x[i+k] );
+               s[k] = s[k] < a ? a : s[k];
+            }
+            for( ; i < end; i++ )
+            {
+               s[0] = max( s[0], fabs( x[i] ));
+            }
+            r[0] = maxLanes( s );
+         }
+   };
+
+   class DotKernel
+   {
+      public:
+         DotKernel( const double* x_, const double* y_ )
+         : x( x_ ), y( y_ )
+         {}
+
+         static const bool maximum = false;
+         const double* x;
+         const double* y;
+
+         void operator()( long begin, long end, double* r ) const
+         {
+            double s[ reductionLanes ] = { 0. };
+            long i = begin;
+            for( ; i + reductionLanes <= end; i += reductionLanes )
+            for( int k = 0; k < reductionLanes; k++ )
+            {
+               s[k] += x[i+k] * y[i+k];
+            }
+            for( ; i < end; i++ )
+            {
+               s[0] += x[i] * y[i];
+            }
+            r[0] = sumLanes( s );
+         }
+   };
+
+   class WeightedDotKernel
+   {
+      public:
+         WeightedDotKernel( const double* x_, const double* w_, const double* y_ )
+         : x( x_ ), w( w_ ), y( y_ )
+         {}
+
+         static const bool maximum = false;
+         const double* x;
+         const double* w;
+         const double* y;
+
+         void operator()( long begin, long end, double* r ) const
+         {
+            double s[ reductionLanes ] = { 0. };
+            long i = begin;
+            for( ; i + reductionLanes <= end; i += reductionLanes )
+            for( int k = 0; k < reductionLanes; k++ )
+            {
+               s[k] += x[i+k] * w[i+k] * y[i+k];
+            }
+            for( ; i < end; i++ )
+            {
+               s[0] += x[i] * w[i] * y[i];
+            }
+            r[0] = sumLanes( s );
+         }
+   };
+
+   class ComplexSumKernel
+   {
+      public:
+         ComplexSumKernel( const double* z_ )
+         : z( z_ )
+         {}
+
+         static const bool maximum = false;
+         const double* z;
+
+         void operator()( long begin, long end, double* r ) const
+         {
+            // even lanes accumulate real parts, odd lanes imaginary parts
+            double s[ reductionLanes ] = { 0. };
+            long i = 2*begin;
+            for( ; i + reductionLanes <= 2*end; i += reductionLanes )
+            for( int k = 0; k < reductionLanes; k++ )
+            {
+               s[k] += z[i+k];
+            }
+            for( ; i < 2*end; i += 2 )
+            {
+               s[0] += z[i+0];
+               s[1] += z[i+1];
+            }
+            r[0] = ( s[0] + s[2] ) + ( s[4] + s[6] );
+            r[1] = ( s[1] + s[3] ) + ( s[5] + s[7] );
+         }
+   };
+
+   class ComplexSumAbsKernel
+   {
+      public:
+         ComplexSumAbsKernel( const double* z_ )
+         : z( z_ )
+         {}
+
+         static const bool maximum = false;
+         const double* z;
+
+         void operator()( long begin, long end, double* r ) const
+         {
+            double s[ reductionLanes ] = { 0. };
+            long i = begin;
+            for( ; i + reductionLanes <= end; i += reductionLanes )
+            for( int k = 0; k < reductionLanes; k++ )
+            {
+               double a = z[2*(i+k)+0];
+               double b = z[2*(i+k)+1];
+               s[k] += sqrt( a*a + b*b );
+            }
+            for( ; i < end; i++ )
+            {
+               s[0] += sqrt( z[2*i+0]*z[2*i+0] + z[2*i+1]*z[2*i+1] );
+            }
+            r[0] = sumLanes( s );
+         }
+   };
+
+   class ComplexMaxAbsKernel
+   {
+      public:
+         ComplexMaxAbsKernel( const double* z_ )
+         : z( z_ )
+         {}
+
+         static const bool maximum = true;
+         const double* z;
+
+         void operator()( long begin, long end, double* r ) const
+         {
+            // compare squared moduli, taking a single square root at the end
+            double s[ reductionLanes ] = { 0. };
+            long i = begin;
+            for( ; i + reductionLanes <= end; i += reductionLanes )
+            for( int k = 0; k < reductionLanes; k++ )
+            {
+               double a = z[2*(i+k)+0];
+               double b = z[2*(i+k)+1];
+               double a2 = a*a + b*b;
+               s[k] = s[k] < a2 ? a2 : s[k];
+            }
+            for( ; i < end; i++ )
+            {
+               s[0] = max( s[0], z[2*i+0]*z[2*i+0] + z[2*i+1]*z[2*i+1] );
+            }
+            r[0] = sqrt( maxLanes( s ));
+         }
+   };
+
+   class ComplexDotKernel
+   {
+      public:
+         ComplexDotKernel( const double* x_, const double* y_ )
+         : x( x_ ), y( y_ )
+         {}
+
+         static const bool maximum = false;
+         const double* x;
+         const double* y;
+
+         void operator()( long begin, long end, double* r ) const
+         {
+            double sr[ reductionLanes ] = { 0. };
+            double si[ reductionLanes ] = { 0. };
+            long i = begin;
+            for( ; i + reductionLanes <= end; i += reductionLanes )
+            for( int k = 0; k < reductionLanes; k++ )
+            {
+               double xr = x[2*(i+k)+0], xi = x[2*(i+k)+1];
+               double yr = y[2*(i+k)+0], yi = y[2*(i+k)+1];
+               sr[k] += xr*yr + xi*yi;
+               si[k] += xr*yi - xi*yr;
+            }
+            for( ; i < end; i++ )
+            {
+               double xr = x[2*i+0], xi = x[2*i+1];
+               double yr = y[2*i+0], yi = y[2*i+1];
+               sr[0] += xr*yr + xi*yi;
+               si[0] += xr*yi - xi*yr;
+            }
+            r[0] = sumLanes( sr );
+            r[1] = sumLanes( si );
+         }
+   };
+
+   class ComplexWeightedDotKernel
+   {
+      public:
+         ComplexWeightedDotKernel( const double* x_, const double* w_, const double* y_ )
+         : x( x_ ), w( w_ ), y( y_ )
+         {}
+
+         static const bool maximum = false;
+         const double* x;
+         const double* w;
+         const double* y;
+
+         void operator()( long begin, long end, double* r ) const
+         {
+            double sr[ reductionLanes ] = { 0. };
+            double si[ reductionLanes ] = { 0. };
+            long i = begin;
+            for( ; i + reductionLanes <= end; i += reductionLanes )
+            for( int k = 0; k < reductionLanes; k++ )
+            {
+               accumulate( i+k, sr[k], si[k] );
+            }
+            for( ; i < end; i++ )
+            {
+               accumulate( i, sr[0], si[0] );
+            }
+            r[0] = sumLanes( sr );
+            r[1] = sumLanes( si );
+         }
+
+         void accumulate( long i, double& sr, double& si ) const
+         // adds conj(x[i]) w[i] y[i] to (sr,si)
+         {
+            double xr = x[2*i+0], xi = x[2*i+1];
+            double wr = w[2*i+0], wi = w[2*i+1];
+            double yr = y[2*i+0], yi = y[2*i+1];
+            double ur = xr*wr + xi*wi; // u = conj(x) w
+            double ui = xr*wi - xi*wr;
+            sr += ur*yr - ui*yi;
+            si += ur*yi + ui*yr;
+         }
+   };
+
+   class MultiDotKernel
+   {
+      public:
+         MultiDotKernel( int nPairs_, const double* const* x_, const double* const* y_ )
+         : nPairs( nPairs_ ), x( x_ ), y( y_ )
+         {}
+
+         static const bool maximum = false;
+         int nPairs;
+         const double* const* x;
+         const double* const* y;
+
+         void operator()( long begin, long end, double* r ) const
+         {
+            // the block is small enough to stay in cache between pairs
+            for( int p = 0; p < nPairs; p++ )
+            {
+               DotKernel( x[p], y[p] )( begin, end, &r[p] );
+            }
+         }
+   };
+
+   class PlanarAbsKernel
+   {
+      public:
+         PlanarAbsKernel( int nPlanes_, const double* const* x_ )
+         : nPlanes( nPlanes_ ), x( x_ )
+         {}
+
+         int nPlanes;
+         const double* const* x;
+
+         void modulus( long i, double* a ) const
+         // stores the moduli of entries i through i+reductionLanes-1 in a
+         {
+            for( int k = 0; k < reductionLanes; k++ )
+            {
+               a[k] = 0.;
+            }
+            for( int p = 0; p < nPlanes; p++ )
+            for( int k = 0; k < reductionLanes; k++ )
+            {
+               a[k] += x[p][i+k] * x[p][i+k];
+            }
+            for( int k = 0; k < reductionLanes; k++ )
+            {
+               a[k] = sqrt( a[k] );
+            }
+         }
+
+         double modulus( long i ) const
+         // returns the modulus of entry i
+         {
+            double a = 0.;
+            for( int p = 0; p < nPlanes; p++ )
+            {
+               a += x[p][i] * x[p][i];
+            }
+            return sqrt( a );
+         }
+   };
+
+   class PlanarSumAbsKernel : public PlanarAbsKernel
+   {
+      public:
+         PlanarSumAbsKernel( int nPlanes_, const double* const* x_ )
+         : PlanarAbsKernel( nPlanes_, x_ )
+         {}
+
+         static const bool maximum = false;
+
+         void operator()( long begin, long end, double* r ) const
+         {
+            double s[ reductionLanes ] = { 0. };
+            double a[ reductionLanes ];
+            long i = begin;
+            for( ; i + reductionLanes <= end; i += reductionLanes )
+            {
+               modulus( i, a );
+               for( int k = 0; k < reductionLanes; k++ )
+               {
+                  s[k] += a[k];
+               }
+            }
+            for( ; i < end; i++ )
+            {
+               s[0] += modulus( i );
+            }
+            r[0] = sumLanes( s );
+         }
+   };
+
+   class PlanarMaxAbsKernel : public PlanarAbsKernel
+   {
+      public:
+         PlanarMaxAbsKernel( int nPlanes_, const double* const* x_ )
+         : PlanarAbsKernel( nPlanes_, x_ )
+         {}
+
+         static const bool maximum = true;
+
+         void operator()( long begin, long end, double* r ) const
+         {
+            double s[ reductionLanes ] = { 0. };
+            double a[ reductionLanes ];
+            long i = begin;
+            for( ; i + reductionLanes <= end; i += reductionLanes )
+            {
+               modulus( i, a );
+               for( int k = 0; k < reductionLanes; k++ )
+               {
+                  s[k] = s[k] < a[k] ? a[k] : s[k];
+               }
+            }
+            for( ; i < end; i++ )
+            {
+               s[0] = max( s[0], modulus( i ));
+            }
+            r[0] = maxLanes( s );
+         }
+   };
+
+   template <class Kernel>
+   class ReductionBlock : public ThreadPool::Task
+   {
+      public:
+         ReductionBlock( const Kernel& kernel_, long begin_, long end_, double* r_ )
+         : kernel( kernel_ ), begin( begin_ ), end( end_ ), r( r_ )
+         {}
+
+         virtual void run( void )
+         {
+            kernel( begin, end, r );
+         }
+
+      protected:
+         const Kernel& kernel;
+         long begin;
+         long end;
+         double* r;
+   };
+
+   template <class Kernel>
+   void reduce( const Kernel& kernel, long n, int width, int nThreads, double* r )
+   // reduces the n entries seen by kernel into r[0], ..., r[width-1]
+   {
+      long nBlocks = ( n + reductionBlockSize - 1 ) / reductionBlockSize;
+      vector<double> partials( width*nBlocks, 0. );
+
+      if( nThreads == 1 || n < parallelReductionSize )
+      {
+         for( long b = 0; b < nBlocks; b++ )
+         {
+            long begin = b*reductionBlockSize;
+            long end = min( n, begin + reductionBlockSize );
+            kernel( begin, end, &partials[width*b] );
+         }
+      }
+      else
+      {
+         vector<ThreadPool::Task*> tasks;
+         for( long b = 0; b < nBlocks; b++ )
+         {
+            long begin = b*reductionBlockSize;
+            long end = min( n, begin + reductionBlockSize );
+            tasks.push_back( new ReductionBlock<Kernel>( kernel, begin, end, &partials[width*b] ));
+         }
+
+         ThreadPool pool( nThreads );
+         pool.run( tasks );
+
+         for( size_t k = 0; k < tasks.size(); k++ )
+         {
+            delete tasks[k];
+         }
+      }
+
+      // combine blocks in order, independent of how they were scheduled
+      for( int k = 0; k < width; k++ )
+      {
+         r[k] = 0.;
+      }
+      for( long b = 0; b < nBlocks; b++ )
+      for( int k = 0; k < width; k++ )
+      {
+         if( Kernel::maximum )
+         {
+            r[k] = max( r[k], partials[width*b+k] );
+         }
+         else
+         {
+            r[k] += partials[width*b+k];
+         }
+      }
+   }
+
+   double Reduction :: sum( const double* x, long n, int nThreads )
+   {
+      double r;
+      reduce( SumKernel( x ), n, 1, nThreads, &r );
+      return r;
+   }
+
+   double Reduction :: sumAbs( const double* x, long n, int nThreads )
+   {
+      double r;
+      reduce( SumAbsKernel( x ), n, 1, nThreads, &r );
+      return r;
+   }
+
+   double Reduction :: maxAbs( const double* x, long n, int nThreads )
+   {
+      double r;
+      reduce( MaxAbsKernel( x ), n, 1, nThreads, &r );
+      return r;
+   }
+
+   double Reduction :: sumSquares( const double* x, long n, int nThreads )
+   {
+      double r;
+      reduce( DotKernel( x, x ), n, 1, nThreads, &r );
+      return r;
+   }
+
+   double Reduction :: dot( const double* x, const double* y, long n, int nThreads )
+   {
+      double r;
+      reduce( DotKernel( x, y ), n, 1, nThreads, &r );
+      return r;
+   }
+
+   double Reduction :: dot( const double* x, const double* w, const double* y, long n, int nThreads )
+   {
+      double r;
+      reduce( WeightedDotKernel( x, w, y ), n, 1, nThreads, &r );
+      return r;
+   }
+
+   void Reduction :: complexSum( const double* z, long n, double& re, double& im, int nThreads )
+   {
+      double r[2];
+      reduce( ComplexSumKernel( z ), n, 2, nThreads, r );
+      re = r[0]; im = r[1];
+   }
+
+   double Reduction :: complexSumAbs( const double* z, long n, int nThreads )
+   {
+      double r;
+      reduce( ComplexSumAbsKernel( z ), n, 1, nThreads, &r );
+      return r;
+   }
+
+   double Reduction :: complexMaxAbs( const double* z, long n, int nThreads )
+   {
+      double r;
+      reduce( ComplexMaxAbsKernel( z ), n, 1, nThreads, &r );
+      return r;
+   }
+
+   void Reduction :: complexDot( const double* x, const double* y, long n, double& re, double& im, int nThreads )
+   {
+      double r[2];
+      reduce( ComplexDotKernel( x, y ), n, 2, nThreads, r );
+      re = r[0]; im = r[1];
+   }
+
+   void Reduction :: complexDot( const double* x, const double* w, const double* y, long n, double& re, double& im, int nThreads )
+   {
+      double r[2];
+      reduce( ComplexWeightedDotKernel( x, w, y ), n, 2, nThreads, r );
+      re = r[0]; im = r[1];
+   }
+
+   void Reduction :: dots( int nPairs, const double* const* x, const double* const* y, long n, double* r, int nThreads )
+   {
+      reduce( MultiDotKernel( nPairs, x, y ), n, nPairs, nThreads, r );
+   }
+
+   double Reduction :: planarSumAbs( int nPlanes, const double* const* x, long n, int nThreads )
+   {
+      double r;
+      reduce( PlanarSumAbsKernel( nPlanes, x ), n, 1, nThreads, &r );
+      return r;
+   }
+
+   double Reduction :: planarMaxAbs( int nPlanes, const double* const* x, long n, int nThreads )
+   {
+      double r;
+      reduce( PlanarMaxAbsKernel( nPlanes, x ), n, 1, nThreads, &r );
+      return r;
+   }
+}
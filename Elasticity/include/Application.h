@@ -102,7 +102,7 @@ namespace DDG
             Vector e01 = v1->position - v0->position;
             Vector e12 = v2->position - v1->position;
 
-            DenseMatrix<Real> A0(2,2);
+            Mat2 A0;
             A0(0,0) = e01.x; A0(0,1) = e12.x;
             A0(1,0) = e01.y; A0(1,1) = e12.y;
             
@@ -114,12 +114,12 @@ namespace DDG
             e01 = v1->position - v0->position;
             e12 = v2->position - v1->position;
             
-            DenseMatrix<Real> A1(2,2);
+            Mat2 A1;
             A1(0,0) = e01.x; A1(0,1) = e12.x;
             A1(1,0) = e01.y; A1(1,1) = e12.y;
             
             // ortho(A1*inv(A0))
-            DenseMatrix<Real> M = A1 * PolarDecomposition2x2::invert(A0);
+            Mat2 M = A1 * PolarDecomposition2x2::invert(A0);
             Complex z = PolarDecomposition2x2::extractOrthogonalPart(M);
             angle(fA->index,0) = z;
          }
@@ -150,7 +150,6 @@ namespace DDG
              v ++ )
          {
             Complex sum;
-            Vector pi = v->position;
             HalfEdgeIter he = v->he;
             do
             {
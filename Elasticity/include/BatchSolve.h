@@ -0,0 +1,85 @@
+// -----------------------------------------------------------------------------
+// libDDG -- BatchSolve.h
+// -----------------------------------------------------------------------------
+//
+// BatchSolve runs a list of independent positive-definite solves in parallel
+// (see ThreadPool.h).  Each job either factors and solves its own matrix, or
+// backsolves against a factor that was computed beforehand; several jobs may
+// share the same factor.  For example, to solve for several right-hand sides
+// that only become available one at a time:
+//
+//    SparseFactor<Real> L;
+//    L.build( A );
+//
+//    std::vector< SolveJob<Real> > jobs;
+//    for( int k = 0; k < n; k++ )
+//    {
+//       jobs.push_back( SolveJob<Real>( L, x[k], b[k] ));
+//    }
+//    solvePositiveDefinite( jobs );
+//
+// Jobs may also solve into views, so that each solution lands directly in
+// its own column of a single matrix:
+//
+//    jobs.push_back( SolveJob<Real>( L, X.column(k), B.column(k) ));
+//
+// Distinct jobs must use distinct x, b, and (if given) A, since converting a
+// matrix to CHOLMOD format modifies it.  The wall-clock time of each job is
+// recorded in SolveJob::time, and its solver statistics in SolveJob::stats.
+//
+
+#ifndef DDG_BATCHSOLVE_H
+#define DDG_BATCHSOLVE_H
+
+#include <vector>
+#include "Types.h"
+#include "SparseMatrix.h"
+#include "DenseMatrix.h"
+#include "DenseView.h"
+#include "ThreadPool.h"
+#include "SolverStats.h"
+
+namespace DDG
+{
+   template <class T>
+   class SolveJob : public ThreadPool::Task
+   {
+      public:
+         SolveJob( SparseMatrix<T>& A, DenseMatrix<T>& x, DenseMatrix<T>& b );
+         // job that solves Ax = b using sparse Cholesky factorization
+
+         SolveJob( SparseFactor<T>& L, DenseMatrix<T>& x, DenseMatrix<T>& b );
+         // job that backsolves LL'x = b using a prefactored matrix
+
+         SolveJob( SparseFactor<T>& L, DenseView<T> x, DenseView<T> b );
+         // job that backsolves LL'x = b into a view, e.g., into one column
+         // of a larger matrix (see DenseView.h)
+
+         virtual void run( void );
+         // performs the solve
+
+         double time;
+         // wall-clock time spent on this job, in seconds (set by run())
+
+         SolverStats stats;
+         // statistics of the solve (set by run(); empty for backsolves)
+
+      protected:
+         SparseMatrix<T>* A;
+         SparseFactor<T>* L;
+         DenseMatrix<T>* x;
+         DenseMatrix<T>* b;
+         DenseView<T> xView;
+         DenseView<T> bView;
+         // views used when x and b are NULL
+   };
+
+   template <class T>
+   void solvePositiveDefinite( std::vector< SolveJob<T> >& jobs, int nThreads = 0 );
+   // runs all jobs in parallel on nThreads threads (or one thread per processor
+   // if nThreads is zero), and reports the time taken by each job
+}
+
+#include "BatchSolve.inl"
+
+#endif
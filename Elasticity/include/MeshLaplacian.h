@@ -0,0 +1,92 @@
+// -----------------------------------------------------------------------------
+// libDDG -- MeshLaplacian.h
+// -----------------------------------------------------------------------------
+//
+// MeshLaplacian applies the cotan-Laplace operator d0^T star1 d0 of a mesh
+// (optionally plus a multiple of star0) without assembling a SparseMatrix.  The
+// cotan weights are computed once, in the constructor, and stored per vertex
+// as flat arrays of neighbor indices and weights, so that each application is
+// a single sweep over contiguous memory; on large meshes the vertices are split
+// into blocks that are processed in parallel (see ThreadPool.h).  For example,
+// to solve the screened Poisson equation (L + t star0) u = b,
+//
+//    MeshLaplacian<Real> A( mesh, t );
+//    solveConjugateGradient( A, u, b );
+//
+// or to find the first nonconstant eigenfunction of L,
+//
+//    MeshLaplacian<Real> L( mesh );
+//    smallestEigPositiveDefinite( L, x );
+//
+// The operator does not track changes to the mesh; construct a new one after
+// the geometry is modified.
+//
+
+#ifndef DDG_MESHLAPLACIAN_H
+#define DDG_MESHLAPLACIAN_H
+
+#include <vector>
+#include "Mesh.h"
+#include "LinearOperator.h"
+#include "ThreadPool.h"
+
+namespace DDG
+{
+   template <class T>
+   class MeshLaplacian : public LinearOperator<T>
+   {
+      public:
+         MeshLaplacian( const Mesh& mesh, double shift = 0. );
+         // constructs the operator d0^T star1 d0 + shift star0 on the
+         // vertices of mesh
+
+         virtual int size( void ) const;
+         // returns the number of vertices
+
+         virtual void apply( const DenseMatrix<T>& x, DenseMatrix<T>& y ) const;
+         // computes y = Ax
+
+         virtual void diagonal( DenseMatrix<T>& d ) const;
+         // stores the diagonal of the operator in the column vector d
+
+         void setThreads( int nThreads );
+         // sets the number of threads used by apply(); zero means one per
+         // processor, one disables threading
+
+      protected:
+         void applyRange( const DenseMatrix<T>& x, DenseMatrix<T>& y, int begin, int end ) const;
+         // computes rows begin through end-1 of y = Ax
+
+         class Block : public ThreadPool::Task
+         {
+            public:
+               Block( const MeshLaplacian<T>& A, const DenseMatrix<T>& x, DenseMatrix<T>& y, int begin, int end );
+               virtual void run( void );
+
+            protected:
+               const MeshLaplacian<T>& A;
+               const DenseMatrix<T>& x;
+               DenseMatrix<T>& y;
+               int begin, end;
+         };
+
+         std::vector<int> offsets;
+         // neighbors of vertex i are stored in entries offsets[i] through offsets[i+1]-1
+
+         std::vector<int> neighbors;
+         // index of each neighbor
+
+         std::vector<double> weights;
+         // cotan weight of the edge to each neighbor
+
+         std::vector<double> diagonals;
+         // diagonal entry of each row
+
+         int nThreads;
+         // number of threads used by apply()
+   };
+}
+
+#include "MeshLaplacian.inl"
+
+#endif
@@ -0,0 +1,68 @@
+// -----------------------------------------------------------------------------
+// libDDG -- MeshPartition.h
+// -----------------------------------------------------------------------------
+//
+// MeshPartition splits the vertices of a mesh (or the rows of a structurally
+// symmetric matrix) into k subdomains of roughly equal size with few edges
+// between them, by recursive bisection with METIS (via cholmod_l_bisect).  It
+// is used by DomainDecomposition to divide a large solve into independent
+// pieces.  For example,
+//
+//    MeshPartition partition;
+//    partition.build( mesh, 8 );
+//
+//    for( int s = 0; s < partition.nParts(); s++ )
+//    {
+//       for( int k = partition.offsets[s]; k < partition.offsets[s+1]; k++ )
+//       {
+//          int i = partition.members[k];
+//          // ...vertex i belongs to subdomain s...
+//       }
+//    }
+//
+// When k is not a power of two, each bisection is shifted along the boundary
+// between its halves so that their sizes are proportional to the number of
+// subdomains each receives.  If CHOLMOD was built without METIS, vertices are
+// split by index instead.
+//
+
+#ifndef DDG_MESHPARTITION_H
+#define DDG_MESHPARTITION_H
+
+#include <cholmod.h>
+#include <vector>
+#include "Types.h"
+
+namespace DDG
+{
+   class MeshPartition
+   {
+      public:
+         void build( const Mesh& mesh, int k );
+         // splits the vertices of mesh into k subdomains
+
+         void build( cholmod_sparse* A, int k );
+         // splits the rows of the square matrix A into k subdomains, where rows
+         // i and j are adjacent if A_ij is nonzero (the pattern of A is assumed
+         // to be symmetric)
+
+         int nParts( void ) const;
+         // returns the number of subdomains
+
+         int size( void ) const;
+         // returns the number of vertices
+
+         std::vector<int> parts;
+         // subdomain of each vertex
+
+         std::vector<int> offsets;
+         std::vector<int> members;
+         // vertices of subdomain s are members[offsets[s]] through members[offsets[s+1]-1]
+
+      protected:
+         void bisect( cholmod_sparse* A, const std::vector<UF_long>& rows, int firstPart, int nParts );
+         // assigns the given rows of A to subdomains firstPart through firstPart+nParts-1
+   };
+}
+
+#endif
@@ -0,0 +1,147 @@
+// -----------------------------------------------------------------------------
+// libDDG -- Preconditioner.h
+// -----------------------------------------------------------------------------
+//
+// Preconditioners approximate the inverse of a positive-definite (real
+// symmetric or complex Hermitian) matrix A cheaply, and are used to accelerate
+// iterative solvers such as solveConjugateGradient.  Each preconditioner is
+// set up once by build(), which determines its sparsity pattern and values;
+// refactor() recomputes only the values for a matrix with the same pattern
+// (e.g., the Laplacian of a mesh whose vertices have moved).  For example,
+//
+//    IncompleteCholesky<Real> M;
+//    M.build( A );
+//    solveConjugateGradient( A, M, x, b );
+//
+//    // ...modify the entries (but not the pattern) of A...
+//    M.refactor( A );
+//    solveConjugateGradient( A, M, x, b );
+//
+// The following preconditioners are available:
+//
+//    JacobiPreconditioner         -- inverse diagonal; works with any LinearOperator
+//    IncompleteCholesky           -- IC(0), i.e., Cholesky restricted to the pattern of A
+//    IncompleteCholeskyThreshold  -- ICT, which keeps fill entries above a drop tolerance
+//    SSORPreconditioner           -- symmetric successive over-relaxation (symmetric
+//                                    Gauss-Seidel for omega = 1)
+//
+// Only the lower triangle of A is used by the incomplete factorizations and
+// SSOR.  Incomplete factorizations may break down for matrices that are not
+// M-matrices; nonpositive pivots are replaced by the corresponding diagonal
+// entry of A, which keeps the preconditioner positive-definite.
+//
+
+#ifndef DDG_PRECONDITIONER_H
+#define DDG_PRECONDITIONER_H
+
+#include <vector>
+#include "Types.h"
+#include "SparseMatrix.h"
+#include "DenseMatrix.h"
+#include "LinearOperator.h"
+
+namespace DDG
+{
+   template <class T>
+   class Preconditioner
+   {
+      public:
+         virtual ~Preconditioner( void );
+         // destructor
+
+         virtual void apply( const DenseMatrix<T>& r, DenseMatrix<T>& z ) const = 0;
+         // computes z = M^-1 r for every column of r; r and z must be distinct
+   };
+
+   template <class T>
+   class JacobiPreconditioner : public Preconditioner<T>
+   {
+      public:
+         void build( const LinearOperator<T>& A );
+         // stores the inverse of the diagonal of A (nonpositive entries are replaced by one)
+
+         virtual void apply( const DenseMatrix<T>& r, DenseMatrix<T>& z ) const;
+         // computes z = D^-1 r
+
+      protected:
+         std::vector<double> invDiagonal;
+   };
+
+   template <class T>
+   class IncompleteCholesky : public Preconditioner<T>
+   {
+      public:
+         virtual ~IncompleteCholesky( void );
+         // destructor
+
+         virtual void build( SparseMatrix<T>& A );
+         // computes an incomplete factor LL^* ~ A with the pattern of the lower triangle of A
+
+         void refactor( SparseMatrix<T>& A );
+         // recomputes the values of the factor, keeping the pattern found by
+         // build(); entries of A outside this pattern are ignored
+
+         virtual void apply( const DenseMatrix<T>& r, DenseMatrix<T>& z ) const;
+         // computes z = (LL^*)^-1 r
+
+         long nnz( void ) const;
+         // returns the number of nonzeros in L
+
+      protected:
+         void factor( cholmod_sparse* A );
+         // computes the values of L on its current pattern
+
+         std::vector<UF_long> Lp;
+         std::vector<UF_long> Li;
+         std::vector<T> Lx;
+         // lower triangular factor in compressed-column format; the
+         // diagonal is the first entry of each column
+   };
+
+   template <class T>
+   class IncompleteCholeskyThreshold : public IncompleteCholesky<T>
+   {
+      public:
+         IncompleteCholeskyThreshold( double dropTolerance = 1e-3, int fill = 10 );
+         // entries smaller than dropTolerance times the norm of the corresponding
+         // column of A are dropped, and each column keeps at most fill times as
+         // many off-diagonal entries as the corresponding column of A
+
+         virtual void build( SparseMatrix<T>& A );
+         // computes an incomplete factor LL^* ~ A, choosing its pattern by
+         // magnitude; refactor() reuses this pattern
+
+         double dropTolerance;
+         int fill;
+   };
+
+   template <class T>
+   class SSORPreconditioner : public Preconditioner<T>
+   {
+      public:
+         SSORPreconditioner( double omega = 1. );
+         // constructs a preconditioner with relaxation parameter 0 < omega < 2
+
+         void build( SparseMatrix<T>& A );
+         // stores the diagonal and strictly lower triangle of A
+
+         void refactor( SparseMatrix<T>& A );
+         // reloads the values of A, keeping the pattern found by build()
+
+         virtual void apply( const DenseMatrix<T>& r, DenseMatrix<T>& z ) const;
+         // computes z = M^-1 r with M = (D + wL) D^-1 (D + wL^*) / (w(2-w))
+
+         double omega;
+
+      protected:
+         std::vector<double> diagonal;
+         std::vector<UF_long> Ap;
+         std::vector<UF_long> Ai;
+         std::vector<T> Ax;
+         // strictly lower triangle in compressed-column format
+   };
+}
+
+#include "Preconditioner.inl"
+
+#endif
@@ -2,7 +2,9 @@
 #define DDG_UTILITY_H
 
 #include <cstdlib>
+#include <chrono>
 #include "Utility.h"
+#include "Real.h"
 #include "Complex.h"
 
 namespace DDG
@@ -12,6 +14,11 @@ namespace DDG
       return x*x;
    }
 
+   inline double realPart( double x ) { return x; }
+   inline double realPart( const Real& x ) { return x; }
+   inline double realPart( const Complex& z ) { return z.re; }
+   // returns the real part of a scalar
+
    inline double unitRand( void )
    {
       const double rRandMax = 1. / (double) RAND_MAX;
@@ -23,6 +30,16 @@ namespace DDG
    {
       return (double)(t1-t0) / (double) CLOCKS_PER_SEC;
    }
+
+   inline double wallClock( void )
+   // returns the current wall-clock time in seconds; unlike clock(), this
+   // measures elapsed time rather than CPU time summed over all threads,
+   // and since the clock is monotonic, differences are never negative
+   {
+      std::chrono::steady_clock::duration t = std::chrono::steady_clock::now().time_since_epoch();
+
+      return std::chrono::duration<double>( t ).count();
+   }
 }
 
 namespace DDGConstants
@@ -0,0 +1,102 @@
+#include <cassert>
+using namespace std;
+
+#include "LinearOperator.h"
+#include "LinearContext.h"
+
+namespace DDG
+{
+   extern LinearContext context;
+
+   template <class T>
+   LinearOperator<T> :: ~LinearOperator( void )
+   // destructor
+   {}
+
+   template <class T>
+   SparseOperator<T> :: SparseOperator( SparseMatrix<T>& A_ )
+   // constructs an operator that applies a copy of the square matrix A
+   {
+      assert( A_.nRows() == A_.nColumns() );
+
+      A = cholmod_l_copy_sparse( A_.to_cholmod(), context );
+      A->stype = 0;
+   }
+
+   template <class T>
+   SparseOperator<T> :: ~SparseOperator( void )
+   // destructor
+   {
+      cholmod_l_free_sparse( &A, context );
+   }
+
+   template <class T>
+   int SparseOperator<T> :: size( void ) const
+   // returns the number of rows (and columns) of the operator
+   {
+      return A->nrow;
+   }
+
+   template <class T>
+   long SparseOperator<T> :: nnz( void ) const
+   // returns the number of stored nonzeros
+   {
+      return ((const UF_long*) A->p)[ A->ncol ];
+   }
+
+   template <class T>
+   void SparseOperator<T> :: apply( const DenseMatrix<T>& x, DenseMatrix<T>& y ) const
+   // computes y = Ax
+   {
+      const UF_long* Ap = (const UF_long*) A->p;
+      const UF_long* Ai = (const UF_long*) A->i;
+      const T*       Ax = (const T*)       A->x;
+      int n = A->ncol;
+
+      assert( x.nRows() == n );
+      assert( &x != &y );
+
+      if( y.nRows() != n || y.nColumns() != x.nColumns() )
+      {
+         y = DenseMatrix<T>( n, x.nColumns() );
+      }
+      else
+      {
+         y.zero();
+      }
+
+      for( int c = 0; c < x.nColumns(); c++ )
+      {
+         for( int j = 0; j < n; j++ )
+         {
+            T xj = x( j, c );
+            for( UF_long p = Ap[j]; p < Ap[j+1]; p++ )
+            {
+               y( Ai[p], c ) += Ax[p] * xj;
+            }
+         }
+      }
+   }
+
+   template <class T>
+   void SparseOperator<T> :: diagonal( DenseMatrix<T>& d ) const
+   // stores the diagonal of the operator in the column vector d
+   {
+      const UF_long* Ap = (const UF_long*) A->p;
+      const UF_long* Ai = (const UF_long*) A->i;
+      const T*       Ax = (const T*)       A->x;
+      int n = A->ncol;
+
+      d = DenseMatrix<T>( n );
+      for( int j = 0; j < n; j++ )
+      {
+         for( UF_long p = Ap[j]; p < Ap[j+1]; p++ )
+         {
+            if( Ai[p] == j )
+            {
+               d( j ) += Ax[p];
+            }
+         }
+      }
+   }
+}
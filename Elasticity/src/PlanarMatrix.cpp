@@ -0,0 +1,134 @@
+#include "PlanarMatrix.h"
+
+namespace DDG
+{
+   template <>
+   cholmod_dense* PlanarMatrix<Complex> :: to_cholmod( void )
+   // returns a zomplex view of the real and imaginary planes
+   {
+      view.nrow = m;
+      view.ncol = n;
+      view.nzmax = m*n;
+      view.d = m;
+      view.x = plane( 0 );
+      view.z = plane( 1 );
+      view.xtype = CHOLMOD_ZOMPLEX;
+      view.dtype = CHOLMOD_DOUBLE;
+
+      return &view;
+   }
+
+   template <>
+   cholmod_dense* PlanarMatrix<Quaternion> :: to_cholmod( void )
+   // returns a copy of the entries as a 4m x n real matrix
+   {
+      if( cData )
+      {
+         cholmod_l_free_dense( &cData, context );
+         cData = NULL;
+      }
+
+      cData = cholmod_l_allocate_dense( m*4, n, m*4, CHOLMOD_REAL, context );
+      double* X = (double*) cData->x;
+
+      // component k of entry i goes to row 4i+k
+      for( int k = 0; k < 4; k++ )
+      {
+         const double* p = plane( k );
+         for( int i = 0; i < m*n; i++ )
+         {
+            X[i*4+k] = p[i];
+         }
+      }
+
+      return cData;
+   }
+
+   template <>
+   const PlanarMatrix<Complex>& PlanarMatrix<Complex> :: operator=( cholmod_dense* B )
+   // copies a complex or zomplex cholmod_dense* into a PlanarMatrix;
+   // takes responsibility for deallocating B
+   {
+      assert( B );
+      assert( B->xtype == CHOLMOD_COMPLEX ||
+              B->xtype == CHOLMOD_ZOMPLEX );
+
+      if( B == &view )
+      {
+         // CHOLMOD wrote directly into our planes
+         return *this;
+      }
+
+      if( m != (int) B->nrow || n != (int) B->ncol )
+      {
+         release();
+         allocate( B->nrow, B->ncol );
+      }
+
+      double* re = plane( 0 );
+      double* im = plane( 1 );
+      double* Bx = (double*) B->x;
+      double* Bz = (double*) B->z;
+      int d = B->d;
+
+      for( int j = 0; j < n; j++ )
+      {
+         if( B->xtype == CHOLMOD_ZOMPLEX )
+         {
+            memcpy( re + m*j, Bx + d*j, m*sizeof(double) );
+            memcpy( im + m*j, Bz + d*j, m*sizeof(double) );
+         }
+         else
+         {
+            for( int i = 0; i < m; i++ )
+            {
+               re[i+m*j] = Bx[(i+d*j)*2+0];
+               im[i+m*j] = Bx[(i+d*j)*2+1];
+            }
+         }
+      }
+
+      cholmod_l_free_dense( &B, context );
+
+      return *this;
+   }
+
+   template <>
+   const PlanarMatrix<Quaternion>& PlanarMatrix<Quaternion> :: operator=( cholmod_dense* B )
+   // copies a 4m x n real cholmod_dense* into a PlanarMatrix;
+   // takes responsibility for deallocating B
+   {
+      assert( B );
+      assert( B->xtype == CHOLMOD_REAL );
+      assert( B->nrow%4 == 0 );
+
+      if( B == cData )
+      {
+         // the copy made by to_cholmod() is about to be freed
+         cData = NULL;
+      }
+
+      if( m != (int) B->nrow/4 || n != (int) B->ncol )
+      {
+         release();
+         allocate( B->nrow/4, B->ncol );
+      }
+
+      double* Bx = (double*) B->x;
+      int d = B->d;
+
+      for( int k = 0; k < 4; k++ )
+      {
+         double* p = plane( k );
+         for( int j = 0; j < n; j++ )
+         for( int i = 0; i < m; i++ )
+         {
+            p[i+m*j] = Bx[i*4+k+d*j];
+         }
+      }
+
+      cholmod_l_free_dense( &B, context );
+
+      return *this;
+   }
+}
@@ -0,0 +1,396 @@
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+using namespace std;
+
+#include "PlanarMatrix.h"
+#include "Complex.h"
+#include "LinearContext.h"
+#include "Quaternion.h"
+#include "Reduction.h"
+
+namespace DDG
+{
+   extern LinearContext context;
+
+   const int planeAlignment = 64;
+   // alignment of each plane, in bytes (one cache line)
+
+   template <>
+   inline int PlanarMatrix<Complex> :: nPlanes( void )
+   {
+      return 2;
+   }
+
+   template <>
+   inline int PlanarMatrix<Quaternion> :: nPlanes( void )
+   {
+      return 4;
+   }
+
+   template <>
+   inline Complex PlanarMatrix<Complex> :: compose( const double* c )
+   {
+      return Complex( c[0], c[1] );
+   }
+
+   template <>
+   inline Quaternion PlanarMatrix<Quaternion> :: compose( const double* c )
+   {
+      return Quaternion( c[0], c[1], c[2], c[3] );
+   }
+
+   template <>
+   inline void PlanarMatrix<Complex> :: decompose( const Complex& a, double* c )
+   {
+      c[0] = a.re;
+      c[1] = a.im;
+   }
+
+   template <>
+   inline void PlanarMatrix<Quaternion> :: decompose( const Quaternion& a, double* c )
+   {
+      for( int k = 0; k < 4; k++ )
+      {
+         c[k] = a[k];
+      }
+   }
+
+   template <class T>
+   PlanarMatrix<T> :: PlanarMatrix( int m_, int n_ )
+   // initialize an mxn matrix of zeros
+   : cData( NULL )
+   {
+      allocate( m_, n_ );
+   }
+
+   template <class T>
+   PlanarMatrix<T> :: PlanarMatrix( const DenseMatrix<T>& A )
+   // converts a DenseMatrix to planar storage
+   : cData( NULL )
+   {
+      allocate( A.nRows(), A.nColumns() );
+
+      const T* a = A.entries();
+      double c[4];
+      for( int i = 0; i < m*n; i++ )
+      {
+         decompose( a[i], c );
+         for( int k = 0; k < nPlanes(); k++ )
+         {
+            x[k*stride+i] = c[k];
+         }
+      }
+   }
+
+   template <class T>
+   PlanarMatrix<T> :: PlanarMatrix( const PlanarMatrix<T>& A )
+   // copy constructor
+   : x( NULL ),
+     cData( NULL )
+   {
+      *this = A;
+   }
+
+   template <class T>
+   PlanarMatrix<T> :: PlanarMatrix( PlanarMatrix<T>&& A )
+   // move constructor
+   : x( NULL ),
+     cData( NULL )
+   {
+      *this = std::move( A );
+   }
+
+   template <class T>
+   const PlanarMatrix<T>& PlanarMatrix<T> :: operator=( const PlanarMatrix<T>& B )
+   // copies B
+   {
+      if( this != &B )
+      {
+         release();
+         allocate( B.m, B.n );
+         if( x )
+         {
+            memcpy( x, B.x, nPlanes()*stride*sizeof(double) );
+         }
+      }
+
+      return *this;
+   }
+
+   template <class T>
+   const PlanarMatrix<T>& PlanarMatrix<T> :: operator=( PlanarMatrix<T>&& B )
+   // takes the entries of B, leaving B empty
+   {
+      if( this != &B )
+      {
+         release();
+
+         m = B.m;
+         n = B.n;
+         stride = B.stride;
+         x = B.x;
+         cData = B.cData;
+
+         B.m = 0;
+         B.stride = 0;
+         B.x = NULL;
+         B.cData = NULL;
+      }
+
+      return *this;
+   }
+
+   template <class T>
+   PlanarMatrix<T> :: ~PlanarMatrix( void )
+   // destructor
+   {
+      release();
+   }
+
+   template <class T>
+   void PlanarMatrix<T> :: allocate( int m_, int n_ )
+   // allocates zeroed planes for an mxn matrix
+   {
+      const long lineSize = planeAlignment / sizeof(double);
+
+      m = m_;
+      n = n_;
+      stride = ( (long) m*n + lineSize - 1 ) / lineSize * lineSize;
+      x = NULL;
+
+      long size = nPlanes()*stride*sizeof(double);
+      if( size > 0 )
+      {
+         void* p;
+         if( posix_memalign( &p, planeAlignment, size ) != 0 )
+         {
+            throw std::bad_alloc();
+         }
+         x = (double*) p;
+         memset( x, 0, size );
+      }
+   }
+
+   template <class T>
+   void PlanarMatrix<T> :: release( void )
+   // frees all storage
+   {
+      free( x );
+      x = NULL;
+
+      if( cData != NULL )
+      {
+         cholmod_l_free_dense( &cData, context );
+         cData = NULL;
+      }
+   }
+
+   template <class T>
+   int PlanarMatrix<T> :: nRows( void ) const
+   // returns the number of rows
+   {
+      return m;
+   }
+
+   template <class T>
+   int PlanarMatrix<T> :: nColumns( void ) const
+   // returns the number of columns
+   {
+      return n;
+   }
+
+   template <class T>
+   double* PlanarMatrix<T> :: plane( int k )
+   // returns component k of all entries
+   {
+      return x + k*stride;
+   }
+
+   template <class T>
+   const double* PlanarMatrix<T> :: plane( int k ) const
+   // returns component k of all entries
+   {
+      return x + k*stride;
+   }
+
+   template <class T>
+   T PlanarMatrix<T> :: operator()( int row, int col ) const
+   {
+      return (*this)( row + m*col );
+   }
+
+   template <class T>
+   T PlanarMatrix<T> :: operator()( int index ) const
+   {
+      double c[4];
+      for( int k = 0; k < nPlanes(); k++ )
+      {
+         c[k] = x[k*stride+index];
+      }
+      return compose( c );
+   }
+
+   template <class T>
+   void PlanarMatrix<T> :: set( int row, int col, const T& value )
+   {
+      set( row + m*col, value );
+   }
+
+   template <class T>
+   void PlanarMatrix<T> :: set( int index, const T& value )
+   {
+      double c[4];
+      decompose( value, c );
+      for( int k = 0; k < nPlanes(); k++ )
+      {
+         x[k*stride+index] = c[k];
+      }
+   }
+
+   template <class T>
+   void PlanarMatrix<T> :: dense( DenseMatrix<T>& A ) const
+   // copies this matrix into A, using interleaved storage
+   {
+      if( A.nRows() != m || A.nColumns() != n )
+      {
+         A = DenseMatrix<T>( m, n );
+      }
+
+      for( int i = 0; i < m*n; i++ )
+      {
+         A(i) = (*this)( i );
+      }
+   }
+
+   template <class T>
+   void PlanarMatrix<T> :: zero( void )
+   // sets all entries to zero
+   {
+      if( x )
+      {
+         memset( x, 0, nPlanes()*stride*sizeof(double) );
+      }
+   }
+
+   template <class T>
+   void PlanarMatrix<T> :: operator+=( const PlanarMatrix<T>& B )
+   // adds B to this matrix
+   {
+      assert( m == B.m && n == B.n );
+
+      long size = nPlanes()*stride;
+      double* a = x;
+      const double* b = B.x;
+      for( long i = 0; i < size; i++ )
+      {
+         a[i] += b[i];
+      }
+   }
+
+   template <class T>
+   void PlanarMatrix<T> :: operator-=( const PlanarMatrix<T>& B )
+   // subtracts B from this matrix
+   {
+      assert( m == B.m && n == B.n );
+
+      long size = nPlanes()*stride;
+      double* a = x;
+      const double* b = B.x;
+      for( long i = 0; i < size; i++ )
+      {
+         a[i] -= b[i];
+      }
+   }
+
+   template <class T>
+   void PlanarMatrix<T> :: operator*=( double c )
+   // multiplies this matrix by the real scalar c
+   {
+      long size = nPlanes()*stride;
+      for( long i = 0; i < size; i++ )
+      {
+         x[i] *= c;
+      }
+   }
+
+   template <class T>
+   double PlanarMatrix<T> :: norm( NormType type ) const
+   {
+      int nThreads = context.reductionThreads;
+      const double* planes[4];
+      for( int k = 0; k < nPlanes(); k++ )
+      {
+         planes[k] = plane( k );
+      }
+
+      double r = 0.;
+
+      if( type == lInfinity )
+      {
+         r = Reduction::planarMaxAbs( nPlanes(), planes, m*n, nThreads );
+      }
+      else if( type == lOne )
+      {
+         r = Reduction::planarSumAbs( nPlanes(), planes, m*n, nThreads );
+      }
+      else if( type == lTwo )
+      {
+         // the padding between planes is zero and does not contribute
+         r = sqrt( Reduction::sumSquares( x, nPlanes()*stride, nThreads ));
+      }
+
+      return r;
+   }
+
+   template <class T>
+   T PlanarMatrix<T> :: sum( void ) const
+   // returns the sum of all entries
+   {
+      double c[4];
+      for( int k = 0; k < nPlanes(); k++ )
+      {
+         c[k] = Reduction::sum( plane( k ), m*n, context.reductionThreads );
+      }
+      return compose( c );
+   }
+
+   template <class T>
+   T inner( const PlanarMatrix<T>& x,
+            const PlanarMatrix<T>& y )
+   // standard inner product
+   {
+      assert( x.nRows()    == y.nRows() &&
+              x.nColumns() == y.nColumns() );
+
+      // conj(x) y is bilinear in the components of x and y, so the inner
+      // product is a combination of the dot products of all pairs of planes
+      const int K = PlanarMatrix<T>::nPlanes();
+      const double* xp[16];
+      const double* yp[16];
+      for( int a = 0; a < K; a++ )
+      for( int b = 0; b < K; b++ )
+      {
+         xp[a*K+b] = x.plane( a );
+         yp[a*K+b] = y.plane( b );
+      }
+
+      double d[16];
+      Reduction::dots( K*K, xp, yp, x.nRows()*x.nColumns(), d, context.reductionThreads );
+
+      T sum = 0.;
+      for( int a = 0; a < K; a++ )
+      for( int b = 0; b < K; b++ )
+      {
+         double ea[4] = { 0., 0., 0., 0. }; ea[a] = 1.;
+         double eb[4] = { 0., 0., 0., 0. }; eb[b] = 1.;
+         T e = PlanarMatrix<T>::compose( ea ).conj() * PlanarMatrix<T>::compose( eb );
+         sum += d[a*K+b] * e;
+      }
+
+      return sum;
+   }
+}
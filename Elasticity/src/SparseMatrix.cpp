@@ -12,17 +12,17 @@ namespace DDG
       {
          cholmod_l_free_sparse( &cData, context );
       }
-      cData = B;
 
-      m = cData->nrow;
-      n = cData->ncol;
+      m = B->nrow;
+      n = B->ncol;
       resize( m, n );
 
-      double* pr = (double*) cData->x;
-      UF_long* ir = (UF_long*) cData->i;
-      UF_long* jc = (UF_long*) cData->p;
+      double* pr = (double*) B->x;
+      UF_long* ir = (UF_long*) B->i;
+      UF_long* jc = (UF_long*) B->p;
 
-      // iterate over columns
+      // iterate over columns; entries arrive in the same (column-major)
+      // order as EntryMap, so each one is inserted at the end of the map
       for( int col = 0; col < n; col++ )
       {
          // iterate over nonzero rows
@@ -30,10 +30,14 @@ namespace DDG
          {
             int row = ir[k];
 
-            (*this)( row, col ) = pr[k];
+            data.insert( data.end(), make_pair( EntryIndex( col, row ), pr[k] ));
          }
       }
 
+      // the entries now live in the map, so B is no longer needed
+      // (to_cholmod() rebuilds the compressed matrix from the map)
+      cholmod_l_free_sparse( &B, context );
+
       return *this;
    }
 
@@ -47,17 +51,17 @@ namespace DDG
       {
          cholmod_l_free_sparse( &cData, context );
       }
-      cData = B;
 
-      m = cData->nrow;
-      n = cData->ncol;
+      m = B->nrow;
+      n = B->ncol;
       resize( m, n );
 
-      double* pr = (double*) cData->x;
-      UF_long* ir = (UF_long*) cData->i;
-      UF_long* jc = (UF_long*) cData->p;
+      double* pr = (double*) B->x;
+      UF_long* ir = (UF_long*) B->i;
+      UF_long* jc = (UF_long*) B->p;
 
-      // iterate over columns
+      // iterate over columns; entries arrive in the same (column-major)
+      // order as EntryMap, so each one is inserted at the end of the map
       for( int col = 0; col < n; col++ )
       {
          // iterate over nonzero rows
@@ -65,10 +69,14 @@ namespace DDG
          {
             int row = ir[k];
 
-            (*this)( row, col ) = Complex( pr[k*2+0], pr[k*2+1] );
+            data.insert( data.end(), make_pair( EntryIndex( col, row ), Complex( pr[k*2+0], pr[k*2+1] ) ));
          }
       }
 
+      // the entries now live in the map, so B is no longer needed
+      // (to_cholmod() rebuilds the compressed matrix from the map)
+      cholmod_l_free_sparse( &B, context );
+
       return *this;
    }
 
@@ -142,20 +150,102 @@ namespace DDG
       pr[i*2+1] = e->second.im;
    }
 
+   template <class T>
+   void backsolveInPlace( cholmod_factor* L,
+                          DenseMatrix<T>& x,
+                          DenseMatrix<T>& b )
+   // solves LL'x = b (or LDL'x = b) directly into the storage of x,
+   // using the calling thread's solve workspace
+   {
+      if( &x == &b )
+      {
+         // the solution cannot overwrite the right-hand side
+         x = cholmod_l_solve( CHOLMOD_A, L, b.to_cholmod(), context );
+         return;
+      }
+
+      if( x.nRows() != (int) L->n || x.nColumns() != b.nColumns() )
+      {
+         x = DenseMatrix<T>( L->n, b.nColumns() );
+      }
+
+      cholmod_dense* X = x.to_cholmod();
+      context.solve( CHOLMOD_A, L, b.to_cholmod(), &X );
+      x = X;
+   }
+
+   void backsolve( cholmod_factor* L,
+                   DenseMatrix<Real>& x,
+                   DenseMatrix<Real>& b )
+   {
+      backsolveInPlace( L, x, b );
+   }
+
+   void backsolve( cholmod_factor* L,
+                   DenseMatrix<Complex>& x,
+                   DenseMatrix<Complex>& b )
+   {
+      backsolveInPlace( L, x, b );
+   }
+
+   template <class T>
+   void backsolveInPlace( cholmod_factor* L,
+                          DenseView<T> x,
+                          DenseView<T> b )
+   // solves LL'x = b (or LDL'x = b) into the entries viewed by x
+   {
+      assert( x.nRows() == (int) L->n && x.nColumns() == b.nColumns() );
+
+      if( !x.isContiguous() || x.entries() == b.entries() )
+      {
+         // CHOLMOD only solves into contiguous storage distinct from b
+         x.assign( cholmod_l_solve( CHOLMOD_A, L, b.to_cholmod(), context ));
+         return;
+      }
+
+      cholmod_dense* X = x.to_cholmod();
+      context.solve( CHOLMOD_A, L, b.to_cholmod(), &X );
+      x.assign( X );
+   }
+
+   void backsolve( cholmod_factor* L,
+                   DenseView<Real> x,
+                   DenseView<Real> b )
+   {
+      backsolveInPlace( L, x, b );
+   }
+
+   void backsolve( cholmod_factor* L,
+                   DenseView<Complex> x,
+                   DenseView<Complex> b )
+   {
+      backsolveInPlace( L, x, b );
+   }
+
    template <>
    void solve( SparseMatrix<Real>& A,
                 DenseMatrix<Real>& x,
                 DenseMatrix<Real>& b )
    // solves the sparse linear system Ax = b using sparse QR factorization
    {
-      int t0 = clock();
-      x = SuiteSparseQR<double>( A.to_cholmod(), b.to_cholmod(), context );
-      int t1 = clock();
-
-      cout << "[qr] time: " << seconds( t0, t1 ) << "s" << "\n";
-      cout << "[qr] max residual: " << residual( A, x, b ) << "\n";
-      cout << "[qr] size: " << A.nRows() << " x " << A.nColumns() << "\n";
-      cout << "[qr] rank: " << (*context).SPQR_istat[4] << "\n";
+      Timer timer;
+      cholmod_sparse* Ac = A.to_cholmod();
+      long nnzA = cholmod_l_nnz( Ac, context );
+      x = SuiteSparseQR<double>( Ac, b.to_cholmod(), context );
+
+      cholmod_common* common = context;
+      SolverStats stats;
+      stats.solver = "qr";
+      timer.stop( stats );
+      stats.nnzA = nnzA;
+      stats.nnzL = common->SPQR_istat[0];
+      stats.flops = common->SPQR_flopcount;
+      stats.rank = common->SPQR_istat[4];
+      if( context.checkResidual() )
+      {
+         stats.residual = residual( Ac, x, b );
+      }
+      context.report( stats );
    }
 
    template <>
@@ -164,14 +254,24 @@ namespace DDG
                 DenseMatrix<Complex>& b )
    // solves the sparse linear system Ax = b using sparse QR factorization
    {
-      int t0 = clock();
-      x = SuiteSparseQR< complex<double> >( A.to_cholmod(), b.to_cholmod(), context );
-      int t1 = clock();
-
-      cout << "[qr] time: " << seconds( t0, t1 ) << "s" << "\n";
-      cout << "[qr] max residual: " << residual( A, x, b ) << "\n";
-      cout << "[qr] size: " << A.nRows() << " x " << A.nColumns() << " (complex)" << "\n";
-      cout << "[qr] rank: " << (*context).SPQR_istat[4] << "\n";
+      Timer timer;
+      cholmod_sparse* Ac = A.to_cholmod();
+      long nnzA = cholmod_l_nnz( Ac, context );
+      x = SuiteSparseQR< complex<double> >( Ac, b.to_cholmod(), context );
+
+      cholmod_common* common = context;
+      SolverStats stats;
+      stats.solver = "qr";
+      timer.stop( stats );
+      stats.nnzA = nnzA;
+      stats.nnzL = common->SPQR_istat[0];
+      stats.flops = common->SPQR_flopcount;
+      stats.rank = common->SPQR_istat[4];
+      if( context.checkResidual() )
+      {
+         stats.residual = residual( Ac, x, b );
+      }
+      context.report( stats );
    }
 
    template <>
@@ -180,23 +280,33 @@ namespace DDG
                 DenseMatrix<Quaternion>& b )
    // solves the sparse linear system Ax = b using sparse QR factorization
    {
-      int t0 = clock();
-      x = SuiteSparseQR<double>( A.to_cholmod(), b.to_cholmod(), context );
-      int t1 = clock();
-
-      cout << "[qr] time: " << seconds( t0, t1 ) << "s" << "\n";
-      cout << "[qr] max residual: " << residual( A, x, b ) << "\n";
-      cout << "[qr] size: " << A.nRows() << " x " << A.nColumns() << " (quaternion)" << "\n";
-      cout << "[qr] rank: " << (*context).SPQR_istat[4]/4 << "\n";
+      Timer timer;
+      cholmod_sparse* Ac = A.to_cholmod();
+      long nnzA = cholmod_l_nnz( Ac, context );
+      x = SuiteSparseQR<double>( Ac, b.to_cholmod(), context );
+
+      cholmod_common* common = context;
+      SolverStats stats;
+      stats.solver = "qr";
+      timer.stop( stats );
+      stats.nnzA = nnzA;
+      stats.nnzL = common->SPQR_istat[0];
+      stats.flops = common->SPQR_flopcount;
+      stats.rank = common->SPQR_istat[4]/4;
+      if( context.checkResidual() )
+      {
+         stats.residual = residual( A, x, b );
+      }
+      context.report( stats );
    }
 
    template <>
-   void solveSymmetric( SparseMatrix<Complex>& A,
-                        DenseMatrix<Complex>& x,
-                        DenseMatrix<Complex>& b )
-   // solves the sparse linear system Ax = b using sparse LU factorization
+   void solveLU( SparseMatrix<Complex>& A,
+                 DenseMatrix<Complex>& x,
+                 DenseMatrix<Complex>& b )
+   // solves the square sparse linear system Ax = b using sparse LU factorization
    {
-      int t0 = clock();
+      Timer timer;
       cholmod_sparse* Ac = A.to_cholmod();
       int n = Ac->nrow;
       UF_long* Ap = (UF_long*) Ac->p;
@@ -204,15 +314,29 @@ namespace DDG
       double*  Ax =  (double*) Ac->x;
       void* Symbolic;
       void* Numeric;
+      double info[ UMFPACK_INFO ];
 
-      umfpack_zl_symbolic( n, n, Ap, Ai, Ax, NULL, &Symbolic, NULL, NULL );
-      umfpack_zl_numeric( Ap, Ai, Ax, NULL, Symbolic, &Numeric, NULL, NULL );
+      if( x.nRows() != n || x.nColumns() != 1 )
+      {
+         x = DenseMatrix<Complex>( n );
+      }
+
+      vector<UF_long> Q;
+      context.orderColumns( Ac, Q );
+      umfpack_zl_qsymbolic( n, n, Ap, Ai, Ax, NULL, Q.empty() ? NULL : &Q[0], &Symbolic, NULL, NULL );
+      umfpack_zl_numeric( Ap, Ai, Ax, NULL, Symbolic, &Numeric, NULL, info );
       umfpack_zl_solve( UMFPACK_A, Ap, Ai, Ax, NULL, (double*) &x(0), NULL, (double*) &b(0), NULL, Numeric, NULL, NULL );
       umfpack_zl_free_symbolic( &Symbolic );
       umfpack_zl_free_numeric( &Numeric );
 
-      int t1 = clock();
-      cout << "[lu] time: " << seconds( t0, t1 ) << "s" << "\n";
-      cout << "[lu] max residual: " << residual( A, x, b ) << "\n";
+      SolverStats stats;
+      stats.solver = "lu";
+      timer.stop( stats );
+      stats.lu( Ap[n], info );
+      if( context.checkResidual() )
+      {
+         stats.residual = residual( Ac, x, b );
+      }
+      context.report( stats );
    }
 }
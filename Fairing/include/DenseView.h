@@ -0,0 +1,114 @@
+// -----------------------------------------------------------------------------
+// libDDG -- DenseView.h
+// -----------------------------------------------------------------------------
+//
+// DenseView refers to a rectangular piece of a DenseMatrix (a column, a range
+// of rows, or a general block) without copying it.  Entries accessed through
+// a view are the entries of the underlying matrix, so writing to a view writes
+// to the matrix.  For instance, to solve for several right-hand sides stored
+// as the columns of B, writing each solution into the matching column of X:
+//
+//    for( int k = 0; k < B.nColumns(); k++ )
+//    {
+//       backsolvePositiveDefinite( L, X.column(k), B.column(k) );
+//    }
+//
+// A view of a block is strided: consecutive columns of the view are the
+// leading dimension (i.e., the number of rows of the underlying matrix) apart.
+// Views are cheap to copy, and copying a view (or assigning one view to
+// another) copies the reference, not the entries; use assign() to copy
+// entries into the viewed storage.  A view remains valid only as long as the
+// underlying matrix is neither resized nor destroyed.
+//
+// Real and complex views can be handed to CHOLMOD directly (see to_cholmod()),
+// and are accepted by the backsolves in SparseMatrix.h, by the sparse
+// matrix-vector product multiply( A, x, y ), and by SolveJob (BatchSolve.h).
+//
+
+#ifndef DDG_DENSEVIEW_H
+#define DDG_DENSEVIEW_H
+
+#include <cholmod.h>
+#include "Types.h"
+#include "DenseMatrix.h"
+
+namespace DDG
+{
+   template <class T>
+   class DenseView
+   {
+      public:
+         DenseView( void );
+         // constructs an empty view
+
+         DenseView( T* data, int m, int n = 1, int ld = 0 );
+         // views the mxn column-major array data, whose columns are ld
+         // entries apart (ld = 0 means the columns are contiguous)
+
+         DenseView( DenseMatrix<T>& A );
+         // views all of A
+
+         int nRows( void ) const;
+         // returns the number of rows
+
+         int nColumns( void ) const;
+         // returns the number of columns
+
+         int leadingDimension( void ) const;
+         // returns the distance between the starts of consecutive columns
+
+         bool isContiguous( void ) const;
+         // returns true if the viewed entries form one contiguous array
+
+         bool overlaps( const DenseView<T>& B ) const;
+         // returns true if this view and B share any entries
+
+         T* entries( void ) const;
+         // returns a pointer to the first viewed entry
+
+         T& operator()( int row, int col ) const;
+         // accesses the specified entry (uses 0-based indexing)
+
+         T& operator()( int index ) const;
+         // accesses the specified entry in column-major order (uses 0-based indexing)
+
+         DenseView<T> column( int col ) const;
+         // returns a view of column col
+
+         DenseView<T> rows( int begin, int end ) const;
+         // returns a view of rows begin through end-1
+
+         DenseView<T> block( int row, int col, int nRows, int nColumns ) const;
+         // returns a view of the nRows x nColumns block whose upper-left
+         // entry is (row,col)
+
+         DenseMatrix<T> copy( void ) const;
+         // returns a copy of the viewed entries as a new matrix
+
+         void assign( const DenseMatrix<T>& A ) const;
+         // copies the entries of A (which must have the same size) into the view
+
+         void zero( const T& val = 0. ) const;
+         // sets all viewed entries to val
+
+         cholmod_dense* to_cholmod( void );
+         // returns a CHOLMOD header describing the viewed entries (not a
+         // copy), which remains valid as long as the view itself
+
+         void assign( cholmod_dense* B );
+         // copies a cholmod_dense* into the viewed entries; takes
+         // responsibility for deallocating B (nothing is copied if B is
+         // the header returned by to_cholmod())
+
+      protected:
+         T* data;
+         int m, n, ld;
+
+         cholmod_dense view;
+         // CHOLMOD header describing data (see to_cholmod())
+   };
+}
+
+#include "DenseView.inl"
+
+#endif
@@ -0,0 +1,82 @@
+// -----------------------------------------------------------------------------
+// libDDG -- MeshHierarchy.h
+// -----------------------------------------------------------------------------
+//
+// MeshHierarchy is a sequence of successively coarser vertex clusterings of a
+// surface mesh, as used by geometric multigrid (see Multigrid.h).  Level 0 is
+// the vertex set of the original mesh; each vertex on level l is assigned to
+// exactly one cluster (``aggregate'') on level l+1.  Clusters are grown over
+// the one-ring neighborhoods encoded by the halfedge data structure, so the
+// coarse levels respect mesh connectivity and geometry rather than just the
+// ordering of vertex indices.  For instance,
+//
+//    Mesh mesh;
+//    MeshHierarchy hierarchy;
+//    hierarchy.build( mesh );
+//
+//    for( int l = 0; l+1 < hierarchy.nLevels(); l++ )
+//    {
+//       const std::vector<int>& a( hierarchy.aggregates( l ));
+//       // vertex i on level l belongs to vertex a[i] on level l+1
+//    }
+//
+// Storage is proportional to the number of vertices and edges of the input
+// (each level keeps only its aggregate map, adjacency, and cluster centers).
+//
+
+#ifndef DDG_MESHHIERARCHY_H
+#define DDG_MESHHIERARCHY_H
+
+#include <vector>
+#include "Vector.h"
+#include "Types.h"
+
+namespace DDG
+{
+   class MeshHierarchy
+   {
+      public:
+         MeshHierarchy( void );
+         // constructs an empty hierarchy
+
+         void build( const Mesh& mesh, int coarsestSize = 1000, int maxLevels = 20 );
+         // clusters the vertices of mesh until a level has no more than
+         // coarsestSize vertices (or maxLevels levels have been built)
+
+         int nLevels( void ) const;
+         // returns the number of levels, including the finest (level 0)
+
+         int size( int level ) const;
+         // returns the number of vertices on the specified level
+
+         const std::vector<int>& aggregates( int level ) const;
+         // returns the map from vertices on the specified level to vertices
+         // on the next coarser level (undefined for the coarsest level)
+
+         const std::vector<Vector>& centers( int level ) const;
+         // returns the cluster centers (mean vertex positions) on the specified level
+
+      protected:
+         typedef std::vector< std::vector<int> > Adjacency;
+
+         void buildFinestLevel( const Mesh& mesh, Adjacency& adjacency );
+         // initializes level 0 from the vertices and edges of mesh
+
+         int aggregate( const Adjacency& adjacency,
+                        const std::vector<Vector>& position,
+                        std::vector<int>& agg ) const;
+         // clusters the vertices of a single level; returns the number of clusters
+
+         void coarsen( const Adjacency& fine,
+                       const std::vector<int>& agg,
+                       int nCoarse,
+                       Adjacency& coarse ) const;
+         // builds the cluster adjacency of the next coarser level
+
+         std::vector<int> levelSize;
+         std::vector< std::vector<int> > levelAggregates;
+         std::vector< std::vector<Vector> > levelCenters;
+   };
+}
+
+#endif
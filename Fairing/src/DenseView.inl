@@ -0,0 +1,172 @@
+#include <cassert>
+#include <functional>
+using namespace std;
+
+#include "DenseView.h"
+#include "LinearContext.h"
+
+namespace DDG
+{
+   extern LinearContext context;
+
+   template <class T>
+   DenseView<T> :: DenseView( void )
+   // constructs an empty view
+   : data( NULL ),
+     m( 0 ),
+     n( 0 ),
+     ld( 0 )
+   {}
+
+   template <class T>
+   DenseView<T> :: DenseView( T* data_, int m_, int n_, int ld_ )
+   // views an mxn column-major array with leading dimension ld
+   : data( data_ ),
+     m( m_ ),
+     n( n_ ),
+     ld( ld_ == 0 ? m_ : ld_ )
+   {
+      assert( ld >= m );
+   }
+
+   template <class T>
+   DenseView<T> :: DenseView( DenseMatrix<T>& A )
+   // views all of A
+   : data( A.nRows()*A.nColumns() == 0 ? NULL : &A(0) ),
+     m( A.nRows() ),
+     n( A.nColumns() ),
+     ld( A.nRows() )
+   {}
+
+   template <class T>
+   int DenseView<T> :: nRows( void ) const
+   // returns the number of rows
+   {
+      return m;
+   }
+
+   template <class T>
+   int DenseView<T> :: nColumns( void ) const
+   // returns the number of columns
+   {
+      return n;
+   }
+
+   template <class T>
+   int DenseView<T> :: leadingDimension( void ) const
+   // returns the distance between the starts of consecutive columns
+   {
+      return ld;
+   }
+
+   template <class T>
+   bool DenseView<T> :: isContiguous( void ) const
+   // returns true if the viewed entries form one contiguous array
+   {
+      return n <= 1 || ld == m;
+   }
+
+   template <class T>
+   bool DenseView<T> :: overlaps( const DenseView<T>& B ) const
+   // returns true if this view and B share any entries
+   {
+      // compare column by column, since two strided blocks of the same
+      // matrix can interleave in memory without sharing any entries
+      less<const T*> before;
+      for( int j = 0; j < n; j++ )
+      for( int k = 0; k < B.n; k++ )
+      {
+         const T* a = data + ld*j;
+         const T* b = B.data + B.ld*k;
+
+         if( m > 0 && B.m > 0 && before( a, b + B.m ) && before( b, a + m ))
+         {
+            return true;
+         }
+      }
+
+      return false;
+   }
+
+   template <class T>
+   T* DenseView<T> :: entries( void ) const
+   // returns a pointer to the first viewed entry
+   {
+      return data;
+   }
+
+   template <class T>
+   T& DenseView<T> :: operator()( int row, int col ) const
+   {
+      return data[row+ld*col];
+   }
+
+   template <class T>
+   T& DenseView<T> :: operator()( int index ) const
+   {
+      return data[index%m+ld*(index/m)];
+   }
+
+   template <class T>
+   DenseView<T> DenseView<T> :: column( int col ) const
+   // returns a view of column col
+   {
+      return block( 0, col, m, 1 );
+   }
+
+   template <class T>
+   DenseView<T> DenseView<T> :: rows( int begin, int end ) const
+   // returns a view of rows begin through end-1
+   {
+      return block( begin, 0, end-begin, n );
+   }
+
+   template <class T>
+   DenseView<T> DenseView<T> :: block( int row, int col, int nRows, int nColumns ) const
+   // returns a view of the nRows x nColumns block starting at (row,col)
+   {
+      assert( row >= 0 && nRows    >= 0 && row + nRows    <= m );
+      assert( col >= 0 && nColumns >= 0 && col + nColumns <= n );
+
+      return DenseView<T>( data + row + ld*col, nRows, nColumns, ld );
+   }
+
+   template <class T>
+   DenseMatrix<T> DenseView<T> :: copy( void ) const
+   // returns a copy of the viewed entries as a new matrix
+   {
+      DenseMatrix<T> A( m, n );
+
+      for( int j = 0; j < n; j++ )
+      for( int i = 0; i < m; i++ )
+      {
+         A( i, j ) = (*this)( i, j );
+      }
+
+      return A;
+   }
+
+   template <class T>
+   void DenseView<T> :: assign( const DenseMatrix<T>& A ) const
+   // copies the entries of A into the view
+   {
+      assert( A.nRows() == m && A.nColumns() == n );
+
+      for( int j = 0; j < n; j++ )
+      for( int i = 0; i < m; i++ )
+      {
+         (*this)( i, j ) = A( i, j );
+      }
+   }
+
+   template <class T>
+   void DenseView<T> :: zero( const T& val ) const
+   // sets all viewed entries to val
+   {
+      for( int j = 0; j < n; j++ )
+      for( int i = 0; i < m; i++ )
+      {
+         (*this)( i, j ) = val;
+      }
+   }
+}
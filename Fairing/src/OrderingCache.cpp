@@ -0,0 +1,246 @@
+#include <cstring>
+#include <fstream>
+#include <iostream>
+using namespace std;
+
+#include "OrderingCache.h"
+
+namespace DDG
+{
+   const char orderingCacheMagic[] = "DDGORD1";
+   // identifies (and versions) files written by OrderingCache::write()
+
+   class OrderingCacheLock
+   // holds a mutex for the lifetime of the object
+   {
+      public:
+         OrderingCacheLock( pthread_mutex_t& m ) : mutex( m ) { pthread_mutex_lock( &mutex ); }
+         ~OrderingCacheLock( void ) { pthread_mutex_unlock( &mutex ); }
+
+      protected:
+         pthread_mutex_t& mutex;
+   };
+
+   OrderingCache :: OrderingCache( void )
+   // constructs an empty cache
+   {
+      pthread_mutex_init( &mutex, NULL );
+   }
+
+   OrderingCache :: ~OrderingCache( void )
+   // destructor
+   {
+      pthread_mutex_destroy( &mutex );
+   }
+
+   bool OrderingCache :: Key :: operator<( const Key& k ) const
+   {
+      if( n      < k.n      ) return true;
+      if( n      > k.n      ) return false;
+      if( nnz    < k.nnz    ) return true;
+      if( nnz    > k.nnz    ) return false;
+      if( hash   < k.hash   ) return true;
+      if( hash   > k.hash   ) return false;
+      if( method < k.method ) return true;
+      if( method > k.method ) return false;
+      return false;
+   }
+
+   bool OrderingCache :: isPermutation( const vector<UF_long>& perm )
+   // returns true if perm contains each of 0, ..., perm.size()-1 exactly once
+   {
+      UF_long n = perm.size();
+      vector<bool> seen( n, false );
+
+      for( UF_long k = 0; k < n; k++ )
+      {
+         UF_long i = perm[k];
+         if( i < 0 || i >= n || seen[i] )
+         {
+            return false;
+         }
+         seen[i] = true;
+      }
+
+      return true;
+   }
+
+   OrderingCache::Key OrderingCache :: key( cholmod_sparse* A, OrderingMethod method )
+   // computes the lookup key for A
+   {
+      const UF_long* Ap = (const UF_long*) A->p;
+      const UF_long* Ai = (const UF_long*) A->i;
+      UF_long n = A->ncol;
+
+      // FNV-1a over the symmetry type and compressed-column pattern
+      const unsigned long prime = 16777619UL;
+      unsigned long h = 2166136261UL;
+      h = ( h ^ (unsigned long) ( A->stype + 1 )) * prime;
+      for( UF_long j = 0; j <= n; j++ )
+      {
+         h = ( h ^ (unsigned long) Ap[j] ) * prime;
+      }
+      for( UF_long k = 0; k < Ap[n]; k++ )
+      {
+         h = ( h ^ (unsigned long) Ai[k] ) * prime;
+      }
+
+      Key k;
+      k.n = n;
+      k.nnz = Ap[n];
+      k.hash = h;
+      k.method = method;
+      return k;
+   }
+
+   bool OrderingCache :: find( cholmod_sparse* A, OrderingMethod method, vector<UF_long>& perm ) const
+   // if an ordering of A computed by the given method has been stored,
+   // copies it into perm and returns true; returns false otherwise
+   {
+      Key k = key( A, method );
+      OrderingCacheLock lock( mutex );
+
+      map< Key, vector<UF_long> >::const_iterator entry = entries.find( k );
+
+      if( entry == entries.end() )
+      {
+         return false;
+      }
+
+      perm = entry->second;
+      return true;
+   }
+
+   void OrderingCache :: insert( cholmod_sparse* A, OrderingMethod method, const UF_long* perm )
+   // stores the ordering perm (of length A->ncol) for matrix A
+   {
+      Key k = key( A, method );
+      OrderingCacheLock lock( mutex );
+
+      entries[k].assign( perm, perm + A->ncol );
+   }
+
+   void OrderingCache :: erase( cholmod_sparse* A, OrderingMethod method )
+   // removes the ordering of A computed by the given method, if any
+   {
+      Key k = key( A, method );
+      OrderingCacheLock lock( mutex );
+
+      entries.erase( k );
+   }
+
+   void OrderingCache :: clear( void )
+   // removes all orderings
+   {
+      OrderingCacheLock lock( mutex );
+      entries.clear();
+   }
+
+   int OrderingCache :: size( void ) const
+   // returns the number of stored orderings
+   {
+      OrderingCacheLock lock( mutex );
+      return entries.size();
+   }
+
+   string OrderingCache :: filename( const string& meshFilename )
+   // returns the conventional cache file name for a mesh file
+   {
+      return meshFilename + ".ordering";
+   }
+
+   int OrderingCache :: read( const string& filename )
+   // adds all orderings stored in the given file
+   {
+      ifstream in( filename.c_str(), ios::binary );
+
+      if( !in.is_open() )
+      {
+         cerr << "Error reading from ordering cache " << filename << endl;
+         return 1;
+      }
+
+      char magic[ sizeof( orderingCacheMagic ) ];
+      long count;
+      in.read( magic, sizeof( magic ));
+      in.read( (char*) &count, sizeof( count ));
+      if( !in || memcmp( magic, orderingCacheMagic, sizeof( magic )) != 0 )
+      {
+         cerr << "Error: " << filename << " does not appear to be a valid ordering cache!" << endl;
+         return 1;
+      }
+
+      OrderingCacheLock lock( mutex );
+      int status = 0;
+      for( long e = 0; e < count; e++ )
+      {
+         Key k;
+         in.read( (char*) &k.n,      sizeof( k.n      ));
+         in.read( (char*) &k.nnz,    sizeof( k.nnz    ));
+         in.read( (char*) &k.hash,   sizeof( k.hash   ));
+         in.read( (char*) &k.method, sizeof( k.method ));
+         if( !in || k.n < 0 )
+         {
+            cerr << "Error: ordering cache " << filename << " is truncated!" << endl;
+            return 1;
+         }
+
+         vector<UF_long> perm( k.n );
+         if( k.n > 0 )
+         {
+            in.read( (char*) &perm[0], k.n * sizeof( UF_long ));
+         }
+         if( !in )
+         {
+            cerr << "Error: ordering cache " << filename << " is truncated!" << endl;
+            return 1;
+         }
+
+         // a corrupted entry would make CHOLMOD reject the ordering
+         if( !isPermutation( perm ))
+         {
+            cerr << "Error: skipping invalid ordering in " << filename << endl;
+            status = 1;
+            continue;
+         }
+
+         entries[k].swap( perm );
+      }
+
+      return status;
+   }
+
+   int OrderingCache :: write( const string& filename ) const
+   // writes all stored orderings to the given file
+   {
+      ofstream out( filename.c_str(), ios::binary );
+
+      if( !out.is_open() )
+      {
+         cerr << "Error writing to ordering cache " << filename << endl;
+         return 1;
+      }
+
+      OrderingCacheLock lock( mutex );
+      long count = entries.size();
+      out.write( orderingCacheMagic, sizeof( orderingCacheMagic ));
+      out.write( (const char*) &count, sizeof( count ));
+
+      for( map< Key, vector<UF_long> >::const_iterator e  = entries.begin();
+                                                       e != entries.end();
+                                                       e ++ )
+      {
+         const Key& k( e->first );
+         out.write( (const char*) &k.n,      sizeof( k.n      ));
+         out.write( (const char*) &k.nnz,    sizeof( k.nnz    ));
+         out.write( (const char*) &k.hash,   sizeof( k.hash   ));
+         out.write( (const char*) &k.method, sizeof( k.method ));
+         if( k.n > 0 )
+         {
+            out.write( (const char*) &e->second[0], k.n * sizeof( UF_long ));
+         }
+      }
+
+      return out.good() ? 0 : 1;
+   }
+}
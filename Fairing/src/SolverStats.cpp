@@ -0,0 +1,117 @@
+#include <umfpack.h>
+using namespace std;
+
+#include "SolverStats.h"
+#include "Utility.h"
+
+namespace DDG
+{
+   SolverStats :: SolverStats( void )
+   // constructs an empty record
+   {
+      clear();
+   }
+
+   void SolverStats :: clear( void )
+   // resets all fields
+   {
+      solver = "";
+      wallTime = -1.;
+      cpuTime = -1.;
+      nnzA = -1;
+      nnzL = -1.;
+      flops = -1.;
+      ordering = -1;
+      rank = -1;
+      iterations = -1;
+      residual = -1.;
+      predictedMemory = -1.;
+      predictedTime = -1.;
+   }
+
+   void SolverStats :: factor( cholmod_sparse* A, cholmod_factor* L, cholmod_common* common )
+   // fills in nnzA, nnzL, flops, and ordering after a CHOLMOD factorization
+   {
+      nnzA = cholmod_l_nnz( A, common );
+
+      if( L )
+      {
+         // lnz and fl are computed by the most recent call to cholmod_l_analyze
+         nnzL = common->lnz;
+         flops = common->fl;
+         ordering = L->ordering;
+      }
+   }
+
+   void SolverStats :: lu( long nnz, const double* info )
+   // fills in nnzA, nnzL, flops, and rank from an UMFPACK info array
+   {
+      nnzA = nnz;
+      nnzL = info[ UMFPACK_LNZ ] + info[ UMFPACK_UNZ ];
+      flops = info[ UMFPACK_FLOPS ];
+      rank = (long) info[ UMFPACK_RANK ];
+   }
+
+   void SolverStats :: print( ostream& os ) const
+   // writes all available fields, one per line, prefixed by the solver name
+   {
+      const string prefix = "[" + solver + "] ";
+
+      if( wallTime   >= 0. ) os << prefix << "time: " << wallTime << "s (cpu: " << cpuTime << "s)" << "\n";
+      if( nnzA       >= 0  ) os << prefix << "nnz(A): " << nnzA << "\n";
+      if( nnzL       >= 0. ) os << prefix << "nnz(factor): " << nnzL << "\n";
+      if( flops      >= 0. ) os << prefix << "flops: " << flops << "\n";
+      if( ordering   >= 0  ) os << prefix << "ordering: " << orderingName( ordering ) << "\n";
+      if( rank       >= 0  ) os << prefix << "rank: " << rank << "\n";
+      if( iterations >= 0  ) os << prefix << "iterations: " << iterations << "\n";
+      if( residual   >= 0. ) os << prefix << "max residual: " << residual << "\n";
+      if( predictedMemory >= 0. ) os << prefix << "predicted factor size: " << predictedMemory << " bytes (" << predictedTime << "s)" << "\n";
+   }
+
+   const char* SolverStats :: orderingName( int ordering )
+   // returns a human-readable name for a CHOLMOD ordering constant
+   {
+      switch( ordering )
+      {
+         case CHOLMOD_NATURAL: return "natural";
+         case CHOLMOD_GIVEN:   return "given (cached)";
+         case CHOLMOD_AMD:     return "AMD";
+         case CHOLMOD_METIS:   return "METIS";
+         case CHOLMOD_NESDIS:  return "nested dissection";
+         case CHOLMOD_COLAMD:  return "COLAMD";
+         default:              return "other";
+      }
+   }
+
+   Timer :: Timer( void )
+   // constructs a timer and starts it
+   {
+      start();
+   }
+
+   void Timer :: start( void )
+   // restarts the timer
+   {
+      wall0 = wallClock();
+      cpu0 = clock();
+   }
+
+   double Timer :: wallTime( void ) const
+   // returns wall-clock seconds elapsed since the timer was started
+   {
+      return wallClock() - wall0;
+   }
+
+   double Timer :: cpuTime( void ) const
+   // returns process CPU seconds elapsed since the timer was started
+   {
+      return (double)( clock() - cpu0 ) / (double) CLOCKS_PER_SEC;
+   }
+
+   void Timer :: stop( SolverStats& stats ) const
+   // stores the elapsed times in stats
+   {
+      stats.wallTime = wallTime();
+      stats.cpuTime = cpuTime();
+   }
+}
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <cmath>
 #include <complex>
+#include <utility>
 using namespace std;
 
 #include <SuiteSparseQR.hpp>
@@ -12,7 +13,9 @@ using namespace std;
 #include "Complex.h"
 #include "SparseMatrix.h"
 #include "DenseMatrix.h"
+#include "DenseView.h"
 #include "LinearContext.h"
+#include "FactorIO.h"
 #include "Utility.h"
 
 namespace DDG
@@ -22,22 +25,49 @@ namespace DDG
    const int maxEigIter = 20;
    // number of iterations used to solve eigenvalue problems
 
+   inline void reportEig( const Timer& timer, double maxResidual )
+   // records statistics for an inverse power iteration (maxResidual
+   // is negative if the residual was not computed)
+   {
+      SolverStats stats;
+      stats.solver = "eig";
+      timer.stop( stats );
+      stats.iterations = maxEigIter;
+      stats.residual = maxResidual;
+      context.report( stats );
+   }
+
    template <class T>
    SparseMatrix<T> :: SparseMatrix( int m_, int n_ )
    // initialize an mxn matrix
    : m( m_ ),
      n( n_ ),
-     cData( NULL )
-   {}
+     cData( NULL ),
+     compressed( false )
+   {
+      pthread_mutex_init( &compressMutex, NULL );
+   }
 
    template <class T>
    SparseMatrix<T> :: SparseMatrix( const SparseMatrix<T>& B )
    // copy constructor
-   : cData( NULL )
+   : cData( NULL ),
+     compressed( false )
    {
+      pthread_mutex_init( &compressMutex, NULL );
       *this = B;
    }
 
+   template <class T>
+   SparseMatrix<T> :: SparseMatrix( SparseMatrix<T>&& B )
+   // move constructor
+   : cData( NULL ),
+     compressed( false )
+   {
+      pthread_mutex_init( &compressMutex, NULL );
+      *this = std::move( B );
+   }
+
    template <class T>
    SparseMatrix<T> :: ~SparseMatrix( void )
    // destructor
@@ -46,6 +76,7 @@ namespace DDG
       {
          cholmod_l_free_sparse( &cData, context );
       }
+      pthread_mutex_destroy( &compressMutex );
    }
 
    template <class T>
@@ -61,6 +92,34 @@ namespace DDG
       m = B.m;
       n = B.n;
       data = B.data;
+      compressed = false;
+
+      return *this;
+   }
+
+   template <class T>
+   const SparseMatrix<T>& SparseMatrix<T> :: operator=( SparseMatrix<T>&& B )
+   // takes the entries of B, leaving B empty
+   {
+      if( this == &B )
+      {
+         return *this;
+      }
+
+      if( cData )
+      {
+         cholmod_l_free_sparse( &cData, context );
+      }
+
+      m = B.m;
+      n = B.n;
+      data = std::move( B.data );
+      cData = B.cData;
+
+      B.data.clear();
+      B.cData = NULL;
+      compressed = false;
+      B.compressed = false;
 
       return *this;
    }
@@ -132,24 +191,13 @@ namespace DDG
    DenseMatrix<T> SparseMatrix<T> :: operator*( const DenseMatrix<T>& B ) const
    // returns product of this matrix with dense B
    {
-      const SparseMatrix<T>& A( *this );
-
       // make sure matrix dimensions agree
-      assert( A.nColumns() == B.nRows() );
+      assert( n == B.nRows() );
 
-      // multiply C = A*B
-      DenseMatrix<T> C( A.nRows(), B.nColumns() );
-      for( const_iterator e  = begin();
-                          e != end();
-                          e ++ )
+      DenseMatrix<T> C( m, B.nColumns() );
+      if( m*B.nColumns() > 0 )
       {
-         int i = e->first.second;
-         int j = e->first.first;
-
-         for( int k = 0; k < B.nColumns(); k++ )
-         {
-            C( i, k ) += e->second * B( j, k );
-         }
+         product( B.entries(), n, &C(0), m, B.nColumns() );
       }
 
       return C;
@@ -225,9 +273,8 @@ namespace DDG
    SparseMatrix<T> SparseMatrix<T> :: operator+( const SparseMatrix<T>& B ) const
    // returns sum of this matrix with B
    {
-      SparseMatrix<T> C( nRows(), nColumns() );
+      SparseMatrix<T> C( *this );
 
-      C += *this;
       C += B;
 
       return C;
@@ -237,9 +284,8 @@ namespace DDG
    SparseMatrix<T> SparseMatrix<T> :: operator-( const SparseMatrix<T>& B ) const
    // returns sum of this matrix with B
    {
-      SparseMatrix<T> C( nRows(), nColumns() );
+      SparseMatrix<T> C( *this );
 
-      C += *this;
       C -= B;
 
       return C;
@@ -287,6 +333,7 @@ namespace DDG
       n = n_;
 
       data.clear();
+      compressed = false;
    }
 
    template <class T>
@@ -425,9 +472,77 @@ namespace DDG
    template <>
    cholmod_sparse* SparseMatrix<Quaternion> :: to_cholmod( void );
 
+   template <class T>
+   void SparseMatrix<T> :: compress( void ) const
+   // brings the compressed-column copy used by product() up to date
+   {
+      pthread_mutex_lock( &compressMutex );
+
+      if( !compressed )
+      {
+         columnStart.assign( n+1, 0 );
+         rowIndex.resize( data.size() );
+         values.resize( data.size() );
+
+         // EntryMap stores entries in column-major order, so this is one pass
+         UF_long k = 0;
+         for( const_iterator e  = data.begin();
+                             e != data.end();
+                             e ++ )
+         {
+            columnStart[ e->first.first + 1 ]++;
+            rowIndex[k] = e->first.second;
+            values[k] = e->second;
+            k++;
+         }
+         for( int j = 0; j < n; j++ )
+         {
+            columnStart[j+1] += columnStart[j];
+         }
+
+         compressed = true;
+      }
+
+      pthread_mutex_unlock( &compressMutex );
+   }
+
+   template <class T>
+   void SparseMatrix<T> :: product( const T* x, int ldx, T* y, int ldy, int nColumns ) const
+   // stores in y the product of this matrix with x
+   {
+      compress();
+
+      const UF_long* Ap = &columnStart[0];
+      const UF_long* Ai = rowIndex.empty() ? NULL : &rowIndex[0];
+      const T*       Ax =   values.empty() ? NULL :   &values[0];
+
+      for( int c = 0; c < nColumns; c++ )
+      {
+         const T* xc = x + ldx*c;
+               T* yc = y + ldy*c;
+
+         for( int i = 0; i < m; i++ )
+         {
+            yc[i] = T( 0. );
+         }
+
+         for( int j = 0; j < n; j++ )
+         {
+            T xj = xc[j];
+            for( UF_long p = Ap[j]; p < Ap[j+1]; p++ )
+            {
+               yc[ Ai[p] ] += Ax[p] * xj;
+            }
+         }
+      }
+   }
+
    template <class T>
    T& SparseMatrix<T> :: operator()( int row, int col )
    {
+      // the caller may change the entry through the returned reference
+      compressed = false;
+
       EntryIndex index( col, row );
       const_iterator entry = data.find( index );
 
@@ -456,6 +571,7 @@ namespace DDG
    template <class T>
    typename SparseMatrix<T>::iterator SparseMatrix<T> :: begin( void )
    {
+      compressed = false;
       return data.begin();
    }
 
@@ -468,6 +584,7 @@ namespace DDG
    template <class T>
    typename SparseMatrix<T>::iterator SparseMatrix<T> :: end( void )
    {
+      compressed = false;
       return data.end();
    }
 
@@ -490,13 +607,96 @@ namespace DDG
       }
    }
 
+   template <class T>
+   bool SparseMatrix<T> :: isHermitian( double relativeTolerance ) const
+   // returns true if this matrix equals its conjugate transpose, up to the given relative tolerance
+   {
+      if( m != n )
+      {
+         return false;
+      }
+
+      for( const_iterator e  = begin();
+                          e != end();
+                          e ++ )
+      {
+         int row = e->first.second;
+         int col = e->first.first;
+
+         // entries missing from the map are zero
+         const_iterator f = data.find( EntryIndex( row, col ));
+         T a = e->second;
+         T b = f == end() ? T( 0. ) : f->second;
+
+         T d = a;
+         d -= b.conj();
+         if( d.norm() > relativeTolerance * max( a.norm(), b.norm() ))
+         {
+            return false;
+         }
+      }
+
+      return true;
+   }
+
    template <class T>
    void solveSymmetric( SparseMatrix<T>& A,
                         DenseMatrix<T>& x,
                         DenseMatrix<T>& b )
-   // solves the sparse linear system Ax = b using sparse LU factorization
+   // solves the symmetric (Hermitian) sparse linear system Ax = b using sparse LDL^T factorization
+   {
+      // CHOLMOD reads one triangle and takes the matrix to be Hermitian, which
+      // would silently give the wrong answer for, e.g., complex-symmetric A
+      if( !A.isHermitian() )
+      {
+         if( context.verbose )
+         {
+            cout << "[ldlt] matrix is not Hermitian; using LU" << "\n";
+         }
+         solveLU( A, x, b );
+         return;
+      }
+
+      Timer timer;
+      SparseFactor<T> L;
+      L.buildLDLT( A );
+
+      if( !L.valid() )
+      {
+         // A is not quasi-definite; use a pivoting LU factorization instead
+         if( context.verbose )
+         {
+            cout << "[ldlt] zero pivot encountered; falling back to LU" << "\n";
+         }
+         solveLU( A, x, b );
+         return;
+      }
+
+      backsolveSymmetric( L, x, b );
+
+      // start from the statistics recorded by the factorization
+      SolverStats stats( context.stats() );
+      stats.solver = "ldlt";
+      timer.stop( stats );
+      if( context.checkResidual() )
+      {
+         stats.residual = residual( A.to_cholmod(), x, b );
+      }
+      context.report( stats );
+   }
+
+   template <>
+   void solveLU( SparseMatrix<Complex>& A,
+                 DenseMatrix<Complex>& x,
+                 DenseMatrix<Complex>& b );
+
+   template <class T>
+   void solveLU( SparseMatrix<T>& A,
+                 DenseMatrix<T>& x,
+                 DenseMatrix<T>& b )
+   // solves the square sparse linear system Ax = b using sparse LU factorization
    {
-      int t0 = clock();
+      Timer timer;
       cholmod_sparse* Ac = A.to_cholmod();
       int n = Ac->nrow;
       UF_long* Ap = (UF_long*) Ac->p;
@@ -504,16 +704,99 @@ namespace DDG
       double*  Ax =  (double*) Ac->x;
       void* Symbolic;
       void* Numeric;
+      double info[ UMFPACK_INFO ];
 
-      umfpack_dl_symbolic( n, n, Ap, Ai, Ax, &Symbolic, NULL, NULL );
-      umfpack_dl_numeric( Ap, Ai, Ax, Symbolic, &Numeric, NULL, NULL );
+      if( x.nRows() != n || x.nColumns() != 1 )
+      {
+         x = DenseMatrix<T>( n );
+      }
+
+      vector<UF_long> Q;
+      context.orderColumns( Ac, Q );
+      umfpack_dl_qsymbolic( n, n, Ap, Ai, Ax, Q.empty() ? NULL : &Q[0], &Symbolic, NULL, NULL );
+      umfpack_dl_numeric( Ap, Ai, Ax, Symbolic, &Numeric, NULL, info );
       umfpack_dl_solve( UMFPACK_A, Ap, Ai, Ax, (double*) &x(0), (double*) &b(0), Numeric, NULL, NULL );
       umfpack_dl_free_symbolic( &Symbolic );
       umfpack_dl_free_numeric( &Numeric );
 
-      int t1 = clock();
-      cout << "[lu] time: " << seconds( t0, t1 ) << "s" << "\n";
-      cout << "[lu] max residual: " << residual( A, x, b ) << "\n";
+      SolverStats stats;
+      stats.solver = "lu";
+      timer.stop( stats );
+      stats.lu( Ap[n], info );
+      if( context.checkResidual() )
+      {
+         stats.residual = residual( Ac, x, b );
+      }
+      context.report( stats );
+   }
+
+   template <class T>
+   void solvePlanned( const SolverPlan& plan,
+                      SparseMatrix<T>& A,
+                      DenseMatrix<T>& x,
+                      DenseMatrix<T>& b )
+   // solves the positive definite sparse linear system Ax = b using the strategy chosen by the planner;
+   // the reported statistics include the prediction of the plan
+   {
+      SolverStrategy strategy = plan.strategy;
+
+      if( strategy == strategyLDLT )
+      {
+         Timer timer;
+         SparseFactor<T> L;
+         L.buildLDLT( A );
+
+         if( L.valid() )
+         {
+            backsolveSymmetric( L, x, b );
+
+            SolverStats stats( context.stats() );
+            stats.solver = "ldlt";
+            timer.stop( stats );
+            if( context.checkResidual() )
+            {
+               stats.residual = residual( A.to_cholmod(), x, b );
+            }
+            stats.predictedMemory = plan.memory;
+            stats.predictedTime = plan.time;
+            context.report( stats );
+            return;
+         }
+         else
+         {
+            // unlike solveSymmetric, never fall back to LU here: its factors
+            // are larger than the Cholesky factor that was just rejected
+            strategy = context.planner.iterative( A.nRows() );
+
+            if( context.verbose )
+            {
+               cout << "[plan] zero pivot in LDL^T; using " << SolverPlanner::name( strategy ) << "\n";
+            }
+         }
+      }
+
+      // run the iterative solver without reporting, so that its statistics
+      // can be reported together with the prediction
+      SolverStats stats;
+      if( strategy == strategyMultigrid )
+      {
+         Multigrid<T> M;
+         M.build( *context.planner.hierarchy, A );
+         M.solve( x, b, stats );
+      }
+      else
+      {
+         // IC(0) needs no more memory than the lower triangle of A
+         IncompleteCholesky<T> M;
+         M.build( A );
+         SparseOperator<T> op( A );
+         conjugateGradient( op, M, x, b, 1e-10, 1000, stats );
+         stats.nnzA = op.nnz();
+      }
+
+      stats.predictedMemory = plan.memory;
+      stats.predictedTime = plan.time;
+      context.report( stats );
    }
 
    template <class T>
@@ -522,18 +805,55 @@ namespace DDG
                                 DenseMatrix<T>& b )
    // solves the positive definite sparse linear system Ax = b using sparse Cholesky factorization
    {
-      int t0 = clock();
+      Timer timer;
+      SolverStats stats;
+      stats.solver = "chol";
+
       cholmod_sparse* Ac = A.to_cholmod();
       Ac->stype = 1;
-      cholmod_factor* L = cholmod_l_analyze( Ac, context );
+      cholmod_factor* L = context.analyze( Ac );
+
+      // fall back to a method that needs less memory if the factor would be too large
+      SolverPlan plan = context.planner.plan( Ac, L, context );
+      if( plan.strategy != strategyCholesky )
+      {
+         if( context.verbose )
+         {
+            cout << "[plan] predicted factor size " << plan.memory << " bytes (" << plan.time << "s) exceeds budget; "
+                 << "using " << SolverPlanner::name( plan.strategy ) << "\n";
+         }
+
+         if( L ) cholmod_l_free_factor( &L, context );
+         solvePlanned( plan, A, x, b );
+         return;
+      }
+      stats.predictedMemory = plan.memory;
+      stats.predictedTime = plan.time;
+
       cholmod_l_factorize( Ac, L, context );
-      x = cholmod_l_solve( CHOLMOD_A, L, b.to_cholmod(), context );
+      if( L->minor < L->n )
+      {
+         // A is not numerically positive-definite, so the factor is unusable
+         plan.strategy = context.planner.iterative( A.nRows() );
+         cerr << "Warning: Cholesky factorization failed at column " << L->minor
+              << "; using " << SolverPlanner::name( plan.strategy ) << endl;
+
+         cholmod_l_free_factor( &L, context );
+         solvePlanned( plan, A, x, b );
+         return;
+      }
+
+      backsolve( L, x, b );
+      stats.factor( Ac, L, context );
 
       if( L ) cholmod_l_free_factor( &L, context );
-      int t1 = clock();
 
-      cout << "[chol] time: " << seconds( t0, t1 ) << "s" << "\n";
-      cout << "[chol] max residual: " << residual( A, x, b ) << "\n";
+      timer.stop( stats );
+      if( context.checkResidual() )
+      {
+         stats.residual = residual( Ac, x, b );
+      }
+      context.report( stats );
    }
 
    template <class T>
@@ -542,7 +862,59 @@ namespace DDG
                                      DenseMatrix<T>& b )
    // backsolves the prefactored positive definite sparse linear system LL'x = b
    {
-      x = cholmod_l_solve( CHOLMOD_A, L.to_cholmod(), b.to_cholmod(), context );
+      backsolve( L.to_cholmod(), x, b );
+   }
+
+   template <class T>
+   void backsolveSymmetric( SparseFactor<T>& L,
+                             DenseMatrix<T>& x,
+                             DenseMatrix<T>& b )
+   // backsolves the prefactored symmetric sparse linear system LDL'x = b
+   {
+      backsolve( L.to_cholmod(), x, b );
+   }
+
+   template <class T>
+   void backsolve( cholmod_factor* L,
+                   DenseMatrix<T>& x,
+                   DenseMatrix<T>& b )
+   // solves LL'x = b (or LDL'x = b) using the CHOLMOD factor L
+   {
+      x = cholmod_l_solve( CHOLMOD_A, L, b.to_cholmod(), context );
+   }
+
+   template <class T>
+   void backsolvePositiveDefinite( SparseFactor<T>& L,
+                                   DenseView<T> x,
+                                   DenseView<T> b )
+   // backsolves LL'x = b into the entries viewed by x
+   {
+      backsolve( L.to_cholmod(), x, b );
+   }
+
+   template <class T>
+   void backsolveSymmetric( SparseFactor<T>& L,
+                            DenseView<T> x,
+                            DenseView<T> b )
+   // backsolves LDL'x = b into the entries viewed by x
+   {
+      backsolve( L.to_cholmod(), x, b );
+   }
+
+   template <class T>
+   void multiply( const SparseMatrix<T>& A,
+                  DenseView<T> x,
+                  DenseView<T> y )
+   // computes y = Ax, writing into the entries viewed by y
+   {
+      assert( A.nColumns() == x.nRows() );
+      assert( A.nRows() == y.nRows() && x.nColumns() == y.nColumns() );
+
+      // y is cleared before x is read, so the two must not share entries
+      assert( !x.overlaps( y ));
+
+      A.product( x.entries(), x.leadingDimension(),
+                 y.entries(), y.leadingDimension(), x.nColumns() );
    }
 
    template <class T>
@@ -552,7 +924,7 @@ namespace DDG
    // solves A x = lambda x for the smallest nonzero eigenvalue lambda
    // A must be symmetric; x is used as an initial guess
    {
-      int t0 = clock();
+      Timer timer;
       for( int iter = 0; iter < maxEigIter; iter++ )
       {
          solve( A, x, x );
@@ -562,10 +934,7 @@ namespace DDG
          }
          x.normalize();
       }
-      int t1 = clock();
-
-      cout << "[eig] time: " << seconds( t0, t1 ) << "s" << "\n";
-      cout << "[eig] max residual: " << residual( A, x ) << "\n";
+      reportEig( timer, context.checkResidual() ? residual( A, x ) : -1. );
    }
 
    template <class T>
@@ -577,7 +946,7 @@ namespace DDG
    {
       // TODO use a symmetric matrix decomposition instead of QR
 
-      int t0 = clock();
+      Timer timer;
 
       // create vector e that has unit norm w.r.t. B
       int n = A.length();
@@ -593,10 +962,7 @@ namespace DDG
          x -= dot( x, Be ).conj()*e;
          x /= dot( x, B*x ).norm(); 
       }
-      int t1 = clock();
-
-      cout << "[eig] time: " << seconds( t0, t1 ) << "s" << "\n";
-      cout << "[eig] max residual: " << residual( A, B, x ) << "\n";
+      reportEig( timer, context.checkResidual() ? residual( A, B, x ) : -1. );
    }
 
    template <class T>
@@ -606,23 +972,24 @@ namespace DDG
    // solves A x = lambda x for the smallest nonzero eigenvalue lambda
    // A must be positive (semi-)definite; x is used as an initial guess
    {
-      int t0 = clock();
+      Timer timer;
       SparseFactor<T> L;
       L.build( A );
 
+      // keeping the right-hand side separate from x lets each
+      // backsolve write into the storage of x
+      DenseMatrix<T> b;
       for( int iter = 0; iter < maxEigIter; iter++ )
       {
-         backsolvePositiveDefinite( L, x, x );
+         b = x;
+         backsolvePositiveDefinite( L, x, b );
          if( ignoreConstantVector )
          {
             x.removeMean();
          }
          x.normalize();
       }
-      int t1 = clock();
-
-      cout << "[eig] time: " << seconds( t0, t1 ) << "s" << "\n";
-      cout << "[eig] max residual: " << residual( A, x ) << "\n";
+      reportEig( timer, context.checkResidual() ? residual( A, x ) : -1. );
    }
 
    template <class T>
@@ -632,7 +999,7 @@ namespace DDG
    // solves A x = lambda x for the smallest nonzero eigenvalue lambda
    // A must be positive (semi-)definite; x is used as an initial guess
    {
-      int t0 = clock();
+      Timer timer;
 
       SparseFactor<T> L;
       L.build( A );
@@ -644,17 +1011,15 @@ namespace DDG
       e /= sqrt( dot( e, B*e ).norm() );
       DenseMatrix<T> Be = B*e;
 
+      DenseMatrix<T> b;
       for( int iter = 0; iter < maxEigIter; iter++ )
       {
-         x = B*x;
-         backsolvePositiveDefinite( L, x, x );
+         b = B*x;
+         backsolvePositiveDefinite( L, x, b );
          x -= dot( x, Be ).conj()*e;
          x /= sqrt( dot( x, B*x ).norm() );
       }
-      int t1 = clock();
-
-      cout << "[eig] time: " << seconds( t0, t1 ) << "s" << "\n";
-      cout << "[eig] max residual: " << residual( A, B, x ) << "\n";
+      reportEig( timer, context.checkResidual() ? residual( A, B, x ) : -1. );
    }
 
    template <class T>
@@ -667,21 +1032,19 @@ namespace DDG
    // x is used as an initial guess
    {
       int iter;
-      int t0 = clock();
+      Timer timer;
       DenseMatrix<T> ET = E.transpose();
       SparseFactor<T> L;
       L.build( A );
 
+      DenseMatrix<T> b;
       for( iter = 0; iter < maxEigIter; iter++ )
       {
-         x = B*x - E*(ET*x);
-         backsolvePositiveDefinite( L, x, x );
+         b = B*x - E*(ET*x);
+         backsolvePositiveDefinite( L, x, b );
          x.normalize();
       }
-      int t1 = clock();
-
-      cout << "[eig] time: " << seconds( t0, t1 ) << "s" << "\n";
-      cout << "[eig] max residual: " << residual( A, B, E, x ) << "\n";
+      reportEig( timer, context.checkResidual() ? residual( A, B, E, x ) : -1. );
    }
 
    template <class T>
@@ -693,6 +1056,47 @@ namespace DDG
       return ( A*x - b ).norm() / b.norm();
    }
 
+   template <class T>
+   double residual( cholmod_sparse* A,
+                    const DenseMatrix<T>& x,
+                    const DenseMatrix<T>& b )
+   // returns the max residual of the linear problem A x = b relative to the largest entry of the solution,
+   // evaluated directly on the compressed-column matrix A
+   {
+      const UF_long* Ap = (const UF_long*) A->p;
+      const UF_long* Ai = (const UF_long*) A->i;
+      const T*       Ax = (const T*)       A->x;
+      int m = A->nrow;
+      int n = A->ncol;
+
+      assert( x.nRows() == n && b.nRows() == m );
+
+      double rMax = 0.;
+      vector<T> r( m );
+      for( int c = 0; c < b.nColumns(); c++ )
+      {
+         // r = b - Ax
+         for( int i = 0; i < m; i++ )
+         {
+            r[i] = b( i, c );
+         }
+         for( int j = 0; j < n; j++ )
+         {
+            T xj = x( j, c );
+            for( UF_long p = Ap[j]; p < Ap[j+1]; p++ )
+            {
+               r[ Ai[p] ] -= Ax[p] * xj;
+            }
+         }
+         for( int i = 0; i < m; i++ )
+         {
+            rMax = max( rMax, r[i].norm() );
+         }
+      }
+
+      return rMax / b.norm();
+   }
+
    template <class T>
    double residual( const SparseMatrix<T>& A,
                     const  DenseMatrix<T>& x )
@@ -770,7 +1174,8 @@ namespace DDG
 
    template <class T>
    SparseFactor<T> :: SparseFactor( void )
-   : L( NULL )
+   : L( NULL ),
+     hash( 0 )
    {}
 
    template <class T>
@@ -782,6 +1187,41 @@ namespace DDG
       }
    }
 
+   template <class T>
+   SparseFactor<T> :: SparseFactor( SparseFactor<T>&& F )
+   : L( F.L ),
+     hash( F.hash )
+   {
+      inversePerm.swap( F.inversePerm );
+      F.L = NULL;
+      F.hash = 0;
+   }
+
+   template <class T>
+   const SparseFactor<T>& SparseFactor<T> :: operator=( SparseFactor<T>&& F )
+   // takes the factor of F, leaving F empty
+   {
+      if( this == &F )
+      {
+         return *this;
+      }
+
+      if( L )
+      {
+         cholmod_l_free_factor( &L, context );
+      }
+
+      L = F.L;
+      hash = F.hash;
+      inversePerm.clear();
+      inversePerm.swap( F.inversePerm );
+
+      F.L = NULL;
+      F.hash = 0;
+
+      return *this;
+   }
+
    template <class T>
    void SparseFactor<T> :: build( SparseMatrix<T>& A )
    {
@@ -790,21 +1230,209 @@ namespace DDG
          cholmod_l_free_factor( &L, context );
          L = NULL;
       }
+      inversePerm.clear();
+
+      Timer timer;
+      SolverStats stats;
+      stats.solver = "factor";
+
+      cholmod_sparse* Ac = A.to_cholmod();
+      Ac->stype = 1;
+      hash = FactorIO::hash( Ac );
+
+      L = context.analyze( Ac );
+      cholmod_l_factorize( Ac, L, context );
+
+      timer.stop( stats );
+      stats.factor( Ac, L, context );
+      context.report( stats );
+   }
+
+   template <class T>
+   void SparseFactor<T> :: buildLDLT( SparseMatrix<T>& A )
+   {
+      if( L )
+      {
+         cholmod_l_free_factor( &L, context );
+         L = NULL;
+      }
+      inversePerm.clear();
 
-      int t0, t1;
+      Timer timer;
+      SolverStats stats;
+      stats.solver = "factor (LDL')";
 
       cholmod_sparse* Ac = A.to_cholmod();
       Ac->stype = 1;
+      hash = FactorIO::hash( Ac );
 
-      t0 = clock();
-      L = cholmod_l_analyze( Ac, context );
-      t1 = clock();
-      cerr << "analyze: " << seconds(t0,t1) << "s" << endl;
+      // CHOLMOD computes LDL' only in simplicial mode; switch the shared
+      // context over for the duration of this factorization
+      cholmod_common* common = context;
+      int supernodal = common->supernodal;
+      int finalLL = common->final_ll;
+      common->supernodal = CHOLMOD_SIMPLICIAL;
+      common->final_ll = false;
 
-      t0 = clock();
+      L = context.analyze( Ac );
       cholmod_l_factorize( Ac, L, context );
-      t1 = clock();
-      cerr << "factorize: " << seconds(t0,t1) << "s" << endl;
+
+      common->supernodal = supernodal;
+      common->final_ll = finalLL;
+
+      timer.stop( stats );
+      stats.factor( Ac, L, context );
+      context.report( stats );
+   }
+
+   template <class T>
+   int SparseFactor<T> :: update( SparseMatrix<T>& C )
+   {
+      return updown( true, C );
+   }
+
+   template <class T>
+   int SparseFactor<T> :: downdate( SparseMatrix<T>& C )
+   {
+      return updown( false, C );
+   }
+
+   template <class T>
+   int SparseFactor<T> :: updown( bool add, SparseMatrix<T>& C )
+   // computes the factorization of A +/- CC^T
+   {
+      assert( L );
+      assert( C.nRows() == (int) L->n );
+
+      if( !prepareModify() )
+      {
+         return 1;
+      }
+
+      Timer timer;
+      SolverStats stats;
+      stats.solver = add ? "update" : "downdate";
+
+      // CHOLMOD factors PAP^T, so C must be permuted the same way
+      cholmod_sparse* Cc = C.to_cholmod();
+      cholmod_sparse* PC = cholmod_l_submatrix( Cc, (UF_long*) L->Perm, L->n, NULL, -1, true, true, context );
+      int ok = cholmod_l_updown( add, PC, L, context );
+      cholmod_l_free_sparse( &PC, context );
+
+      timer.stop( stats );
+      context.report( stats );
+
+      if( !ok )
+      {
+         cerr << "Error: could not " << stats.solver << " factor!" << endl;
+         return 1;
+      }
+
+      // a downdate can leave a matrix that is no longer positive-definite
+      if( L->minor < L->n )
+      {
+         cerr << "Error: matrix is not positive-definite after " << stats.solver << "!" << endl;
+         return 1;
+      }
+
+      return 0;
+   }
+
+   template <class T>
+   int SparseFactor<T> :: removeRow( int i )
+   {
+      assert( L );
+      assert( 0 <= i && i < (int) L->n );
+
+      if( !prepareModify() )
+      {
+         return 1;
+      }
+
+      if( !cholmod_l_rowdel( permutedIndex( i ), NULL, L, context ))
+      {
+         cerr << "Error: could not remove row " << i << " from factor!" << endl;
+         return 1;
+      }
+
+      return 0;
+   }
+
+   template <class T>
+   int SparseFactor<T> :: addRow( int i, SparseMatrix<T>& A )
+   {
+      assert( L );
+      assert( A.nRows() == (int) L->n && A.nColumns() == (int) L->n );
+      assert( 0 <= i && i < (int) L->n );
+
+      if( !prepareModify() )
+      {
+         return 1;
+      }
+
+      // column i of A, with rows permuted to match the factorization of PAP^T
+      cholmod_sparse* Ac = A.to_cholmod();
+      UF_long column = i;
+      cholmod_sparse* R = cholmod_l_submatrix( Ac, (UF_long*) L->Perm, L->n, &column, 1, true, true, context );
+      int ok = cholmod_l_rowadd( permutedIndex( i ), R, L, context );
+      cholmod_l_free_sparse( &R, context );
+
+      if( !ok || L->minor < L->n )
+      {
+         cerr << "Error: could not add row " << i << " to factor!" << endl;
+         return 1;
+      }
+
+      return 0;
+   }
+
+   template <class T>
+   bool SparseFactor<T> :: prepareModify( void )
+   // converts the factor to the representation required by CHOLMOD's
+   // modification routines; returns false if modification is not supported
+   {
+      if( L->xtype != CHOLMOD_REAL )
+      {
+         cerr << "Error: factor modification is only supported for real matrices!" << endl;
+         return false;
+      }
+
+      // updates/downdates operate on a simplicial LDL' factor whose
+      // columns may grow in place
+      if( L->is_super || L->is_ll || L->is_monotonic == false )
+      {
+         cholmod_l_change_factor( CHOLMOD_REAL, false, false, false, true, L, context );
+      }
+
+      // the factor no longer corresponds to the matrix it was built from
+      hash = 0;
+
+      // cache the inverse of the fill-reducing permutation (which is not
+      // changed by modifications) so that permutedIndex() takes O(1) time
+      const UF_long* P = (const UF_long*) L->Perm;
+      if( P && inversePerm.size() != L->n )
+      {
+         inversePerm.resize( L->n );
+         for( size_t k = 0; k < L->n; k++ )
+         {
+            inversePerm[ P[k] ] = k;
+         }
+      }
+
+      return true;
+   }
+
+   template <class T>
+   int SparseFactor<T> :: permutedIndex( int i ) const
+   // returns the row of PAP^T corresponding to row i of A
+   {
+      if( inversePerm.empty() )
+      {
+         // the natural ordering was used
+         return i;
+      }
+
+      return inversePerm[i];
    }
 
    template <class T>
@@ -814,13 +1442,179 @@ namespace DDG
       {
          return false;
       }
+
+      // CHOLMOD reports the column where factorization broke down
+      // (e.g., a zero pivot) via L->minor
+      if( L->minor < L->n )
+      {
+         return false;
+      }
+
       return true;
    }
 
+   template <class T>
+   int SparseFactor<T> :: write( const string& filename ) const
+   {
+      if( !valid() || hash == 0 )
+      {
+         cerr << "Error: only factors built from a matrix can be written to " << filename << endl;
+         return 1;
+      }
+
+      return FactorIO::write( filename, L, hash );
+   }
+
+   template <class T>
+   int SparseFactor<T> :: read( const string& filename, SparseMatrix<T>& A )
+   {
+      Timer timer;
+      SolverStats stats;
+      stats.solver = "factor (read)";
+
+      cholmod_sparse* Ac = A.to_cholmod();
+      Ac->stype = 1;
+      unsigned long h = FactorIO::hash( Ac );
+
+      cholmod_factor* F = FactorIO::read( filename, h, Ac->xtype, context );
+      if( F == NULL )
+      {
+         return 1;
+      }
+
+      if( L )
+      {
+         cholmod_l_free_factor( &L, context );
+      }
+      L = F;
+      hash = h;
+      inversePerm.clear();
+
+      timer.stop( stats );
+      stats.nnzA = cholmod_l_nnz( Ac, context );
+      stats.ordering = L->ordering;
+      context.report( stats );
+
+      return 0;
+   }
+
+   template <class T>
+   string SparseFactor<T> :: filename( const string& meshFilename )
+   {
+      return meshFilename + ".factor";
+   }
+
    template <class T>
    cholmod_factor* SparseFactor<T> :: to_cholmod( void )
    {
       return L;
    }
+
+   template <class T>
+   SparseQRFactor<T> :: SparseQRFactor( void )
+   : QR( NULL ),
+     width( 1 )
+   {}
+
+   template <class T>
+   SparseQRFactor<T> :: ~SparseQRFactor( void )
+   {
+      if( QR )
+      {
+         SuiteSparseQR_free<double>( &QR, context );
+      }
+   }
+
+   template <class T>
+   SparseQRFactor<T> :: SparseQRFactor( SparseQRFactor<T>&& F )
+   : QR( F.QR ),
+     width( F.width )
+   {
+      F.QR = NULL;
+   }
+
+   template <class T>
+   const SparseQRFactor<T>& SparseQRFactor<T> :: operator=( SparseQRFactor<T>&& F )
+   // takes the factorization of F, leaving F empty
+   {
+      if( this == &F )
+      {
+         return *this;
+      }
+
+      if( QR )
+      {
+         SuiteSparseQR_free<double>( &QR, context );
+      }
+
+      QR = F.QR;
+      width = F.width;
+
+      F.QR = NULL;
+
+      return *this;
+   }
+
+   template <class T>
+   void SparseQRFactor<T> :: build( SparseMatrix<T>& A )
+   {
+      if( QR )
+      {
+         SuiteSparseQR_free<double>( &QR, context );
+         QR = NULL;
+      }
+
+      Timer timer;
+      SolverStats stats;
+      stats.solver = "qr factor";
+
+      cholmod_sparse* Ac = A.to_cholmod();
+      assert( Ac->xtype == CHOLMOD_REAL );
+      width = A.nColumns() > 0 ? Ac->ncol / A.nColumns() : 1;
+
+      QR = SuiteSparseQR_factorize<double>( SPQR_ORDERING_DEFAULT, SPQR_DEFAULT_TOL, Ac, context );
+
+      cholmod_common* common = context;
+      timer.stop( stats );
+      stats.nnzA = cholmod_l_nnz( Ac, context );
+      stats.nnzL = common->SPQR_istat[0];
+      stats.flops = common->SPQR_flopcount;
+      stats.rank = rank();
+      context.report( stats );
+   }
+
+   template <class T>
+   bool SparseQRFactor<T> :: valid( void ) const
+   {
+      return QR != NULL;
+   }
+
+   template <class T>
+   int SparseQRFactor<T> :: rank( void ) const
+   {
+      return QR ? QR->rank / width : 0;
+   }
+
+   template <class T>
+   SuiteSparseQR_factorization<double>* SparseQRFactor<T> :: to_cholmod( void )
+   {
+      return QR;
+   }
+
+   template <class T>
+   void backsolve( SparseQRFactor<T>& QR,
+                   DenseMatrix<T>& x,
+                   DenseMatrix<T>& b )
+   // solves Ax = b for every column of b using the prefactored matrix A = QR,
+   // i.e., x = E R^{-1} Q' b, where E is the fill-reducing column permutation
+   {
+      assert( QR.valid() );
+
+      SuiteSparseQR_factorization<double>* F = QR.to_cholmod();
+
+      cholmod_dense* Y = SuiteSparseQR_qmult<double>( SPQR_QTX, F, b.to_cholmod(), context );
+      x = SuiteSparseQR_solve<double>( SPQR_RETX_EQUALS_B, F, Y, context );
+      cholmod_l_free_dense( &Y, context );
+   }
 }
 
@@ -0,0 +1,321 @@
+#include <algorithm>
+#include <iostream>
+#include <unistd.h>
+using namespace std;
+
+#include "ThreadPool.h"
+
+namespace DDG
+{
+   class ThreadPool::Workers
+   {
+      public:
+         Workers( void );
+         // initializes an empty set of workers
+
+         static Workers& get( void );
+         // returns the workers shared by all pools (created on first use, and
+         // never destroyed, since detached threads may still be waiting on them)
+
+         void grow( int n );
+         // starts worker threads until there are at least n of them
+
+         pthread_mutex_t busy;
+         // held by the thread whose batch the workers are running
+
+         pthread_mutex_t mutex;
+         // protects the members below
+
+         pthread_cond_t posted;
+         // signalled when a batch is posted
+
+         pthread_cond_t finished;
+         // signalled when the last worker finishes its part of a batch
+
+         int nWorkers;
+         // number of worker threads started so far
+
+         ThreadPool* batch;
+         // pool whose tasks are being run, or NULL between batches
+
+         unsigned long generation;
+         // number of batches posted so far
+
+         int nParticipants;
+         // threads taking part in the current batch (including the caller,
+         // which acts as worker 0)
+
+         int nActive;
+         // workers that have not yet finished their part of the current batch
+   };
+
+   static pthread_key_t batchKey;
+   static pthread_once_t batchKeyOnce = PTHREAD_ONCE_INIT;
+   static int batchMarker;
+   // the thread-specific value of batchKey is &batchMarker on worker threads,
+   // and on any thread while it is running tasks (NULL otherwise)
+
+   static void createBatchKey( void )
+   {
+      pthread_key_create( &batchKey, NULL );
+   }
+
+   static bool inBatch( void )
+   // returns true if the calling thread is running tasks
+   {
+      pthread_once( &batchKeyOnce, createBatchKey );
+      return pthread_getspecific( batchKey ) != NULL;
+   }
+
+   static void setInBatch( bool value )
+   // marks whether the calling thread is running tasks
+   {
+      pthread_once( &batchKeyOnce, createBatchKey );
+      pthread_setspecific( batchKey, value ? &batchMarker : NULL );
+   }
+
+   ThreadPool::Workers :: Workers( void )
+   : nWorkers( 0 ),
+     batch( NULL ),
+     generation( 0 ),
+     nParticipants( 0 ),
+     nActive( 0 )
+   {
+      pthread_mutex_init( &busy, NULL );
+      pthread_mutex_init( &mutex, NULL );
+      pthread_cond_init( &posted, NULL );
+      pthread_cond_init( &finished, NULL );
+   }
+
+   ThreadPool::Workers& ThreadPool::Workers :: get( void )
+   // returns the workers shared by all pools
+   {
+      static Workers* workers = new Workers;
+      return *workers;
+   }
+
+   void ThreadPool::Workers :: grow( int n )
+   // starts worker threads until there are at least n of them
+   {
+      pthread_attr_t attr;
+      pthread_attr_init( &attr );
+      pthread_attr_setdetachstate( &attr, PTHREAD_CREATE_DETACHED );
+
+      while( nWorkers < n )
+      {
+         pthread_t thread;
+         long index = nWorkers + 1;
+         if( pthread_create( &thread, &attr, work, (void*) index ) != 0 )
+         {
+            cerr << "Warning: could not create worker thread " << index << endl;
+            break;
+         }
+
+         pthread_mutex_lock( &mutex );
+         nWorkers++;
+         pthread_mutex_unlock( &mutex );
+      }
+
+      pthread_attr_destroy( &attr );
+   }
+
+   ThreadPool::Task :: ~Task( void )
+   // destructor
+   {}
+
+   ThreadPool::Queue :: Queue( void )
+   {
+      pthread_mutex_init( &mutex, NULL );
+   }
+
+   ThreadPool::Queue :: ~Queue( void )
+   {
+      pthread_mutex_destroy( &mutex );
+   }
+
+   ThreadPool :: ThreadPool( int nThreads )
+   // constructs a pool with the given number of threads
+   {
+      if( nThreads <= 0 )
+      {
+         nThreads = nProcessors();
+      }
+
+      for( int i = 0; i < nThreads; i++ )
+      {
+         queues.push_back( new Queue );
+      }
+   }
+
+   ThreadPool :: ~ThreadPool( void )
+   // destructor
+   {
+      for( size_t i = 0; i < queues.size(); i++ )
+      {
+         delete queues[i];
+      }
+   }
+
+   int ThreadPool :: nThreads( void ) const
+   // returns the number of threads used by run()
+   {
+      return queues.size();
+   }
+
+   int ThreadPool :: nProcessors( void )
+   // returns the number of available processors
+   {
+      long n = sysconf( _SC_NPROCESSORS_ONLN );
+
+      return n > 0 ? n : 1;
+   }
+
+   void ThreadPool :: run( const vector<Task*>& tasks )
+   // executes all tasks and waits for them to finish
+   {
+      int n = nThreads();
+
+      // nested batches, and batches that only one thread could work on, run
+      // inline; so do batches submitted while the workers are busy elsewhere
+      if( n == 1 || tasks.size() <= 1 || inBatch() )
+      {
+         runInline( tasks );
+         return;
+      }
+
+      Workers& w = Workers::get();
+      if( pthread_mutex_trylock( &w.busy ) != 0 )
+      {
+         runInline( tasks );
+         return;
+      }
+
+      w.grow( n-1 );
+
+      // the calling thread acts as worker 0
+      int nWorkers = min( min( n-1, w.nWorkers ), (int) tasks.size()-1 );
+      for( size_t k = 0; k < tasks.size(); k++ )
+      {
+         queues[ k%(nWorkers+1) ]->tasks.push_back( tasks[k] );
+      }
+
+      pthread_mutex_lock( &w.mutex );
+      w.batch = this;
+      w.nParticipants = nWorkers+1;
+      w.nActive = nWorkers;
+      w.generation++;
+      pthread_cond_broadcast( &w.posted );
+      pthread_mutex_unlock( &w.mutex );
+
+      setInBatch( true );
+      Task* task;
+      while( ( task = next( 0 )) != NULL )
+      {
+         task->run();
+      }
+      setInBatch( false );
+
+      pthread_mutex_lock( &w.mutex );
+      while( w.nActive > 0 )
+      {
+         pthread_cond_wait( &w.finished, &w.mutex );
+      }
+      w.batch = NULL;
+      pthread_mutex_unlock( &w.mutex );
+
+      pthread_mutex_unlock( &w.busy );
+   }
+
+   void ThreadPool :: runInline( const vector<Task*>& tasks )
+   // runs all tasks on the calling thread
+   {
+      bool outer = inBatch();
+      setInBatch( true );
+
+      for( size_t k = 0; k < tasks.size(); k++ )
+      {
+         tasks[k]->run();
+      }
+
+      setInBatch( outer );
+   }
+
+   void* ThreadPool :: work( void* index )
+   // worker thread entry point; waits for batches and helps run their tasks
+   {
+      int i = (int) (long) index;
+      Workers& w = Workers::get();
+      setInBatch( true );
+
+      // a worker is started just before the batch that needs it is posted,
+      // so every batch posted so far is treated as new (batches that have
+      // already finished are skipped, since w.batch is then NULL)
+      pthread_mutex_lock( &w.mutex );
+      unsigned long seen = 0;
+      while( true )
+      {
+         while( w.generation == seen )
+         {
+            pthread_cond_wait( &w.posted, &w.mutex );
+         }
+         seen = w.generation;
+
+         ThreadPool* pool = w.batch;
+         if( pool == NULL || i >= w.nParticipants )
+         {
+            continue;
+         }
+         pthread_mutex_unlock( &w.mutex );
+
+         Task* task;
+         while( ( task = pool->next( i )) != NULL )
+         {
+            task->run();
+         }
+
+         pthread_mutex_lock( &w.mutex );
+         if( --w.nActive == 0 )
+         {
+            pthread_cond_signal( &w.finished );
+         }
+      }
+
+      return NULL;
+   }
+
+   ThreadPool::Task* ThreadPool :: next( int index )
+   // removes the next task for thread index from its own queue, or
+   // steals one from another queue; returns NULL if no work is left
+   {
+      int n = nThreads();
+
+      for( int k = 0; k < n; k++ )
+      {
+         Queue* q = queues[ (index+k)%n ];
+         Task* task = NULL;
+
+         pthread_mutex_lock( &q->mutex );
+         if( !q->tasks.empty() )
+         {
+            if( k == 0 )
+            {
+               task = q->tasks.front();
+               q->tasks.pop_front();
+            }
+            else
+            {
+               task = q->tasks.back();
+               q->tasks.pop_back();
+            }
+         }
+         pthread_mutex_unlock( &q->mutex );
+
+         if( task )
+         {
+            return task;
+         }
+      }
+
+      return NULL;
+   }
+}
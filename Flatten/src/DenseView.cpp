@@ -0,0 +1,92 @@
+#include "DenseView.h"
+#include "Complex.h"
+#include "Real.h"
+
+namespace DDG
+{
+   cholmod_dense* makeViewHeader( cholmod_dense& view, void* data, int m, int n, int ld, int xtype )
+   // fills in a cholmod_dense header describing a (possibly strided) view
+   {
+      // the leading dimension of a single column is irrelevant; reporting it
+      // as m lets CHOLMOD write solutions directly into column views
+      int d = n > 1 ? ld : m;
+
+      view.nrow = m;
+      view.ncol = n;
+      view.nzmax = n > 0 ? d*(n-1) + m : 0;
+      view.d = d;
+      view.x = data;
+      view.z = NULL;
+      view.xtype = xtype;
+      view.dtype = CHOLMOD_DOUBLE;
+
+      return &view;
+   }
+
+   template <>
+   cholmod_dense* DenseView<Real> :: to_cholmod( void )
+   {
+      return makeViewHeader( view, data, m, n, ld, CHOLMOD_REAL );
+   }
+
+   template <>
+   cholmod_dense* DenseView<Complex> :: to_cholmod( void )
+   {
+      return makeViewHeader( view, data, m, n, ld, CHOLMOD_COMPLEX );
+   }
+
+   template <>
+   void DenseView<Real> :: assign( cholmod_dense* B )
+   // copies a cholmod_dense* into the viewed entries;
+   // takes responsibility for deallocating B
+   {
+      assert( B );
+
+      if( B == &view )
+      {
+         // CHOLMOD wrote directly into the viewed entries
+         return;
+      }
+
+      assert( B->xtype == CHOLMOD_REAL );
+      assert( (int) B->nrow == m && (int) B->ncol == n );
+
+      double* x = (double*) B->x;
+      int d = B->d;
+      for( int j = 0; j < n; j++ )
+      for( int i = 0; i < m; i++ )
+      {
+         data[i+ld*j] = x[i+d*j];
+      }
+
+      cholmod_l_free_dense( &B, context );
+   }
+
+   template <>
+   void DenseView<Complex> :: assign( cholmod_dense* B )
+   // copies a cholmod_dense* into the viewed entries;
+   // takes responsibility for deallocating B
+   {
+      assert( B );
+
+      if( B == &view )
+      {
+         // CHOLMOD wrote directly into the viewed entries
+         return;
+      }
+
+      assert( B->xtype == CHOLMOD_COMPLEX );
+      assert( (int) B->nrow == m && (int) B->ncol == n );
+
+      double* x = (double*) B->x;
+      int d = B->d;
+      for( int j = 0; j < n; j++ )
+      for( int i = 0; i < m; i++ )
+      {
+         data[i+ld*j] = Complex( x[(i+d*j)*2+0],
+                                 x[(i+d*j)*2+1] );
+      }
+
+      cholmod_l_free_dense( &B, context );
+   }
+}
@@ -0,0 +1,72 @@
+#include <cmath>
+
+#include "Real.h"
+
+namespace DDG
+{
+   constexpr Real :: Real( double x )
+   // constructs real number with value x
+   : value( x )
+   {}
+
+   constexpr Real :: operator double( void ) const
+   // type cast to double
+   {
+      return value;
+   }
+
+   inline void Real :: operator+=( double x )
+   // increment
+   {
+      value += x;
+   }
+
+   inline void Real :: operator-=( double x )
+   // decrement
+   {
+      value -= x;
+   }
+
+   inline void Real :: operator*=( double x )
+   // multiply
+   {
+      value *= x;
+   }
+
+   inline void Real :: operator/=( double x )
+   // divide
+   {
+      value /= x;
+   }
+
+   constexpr Real Real :: conj( void ) const
+   // simply returns the value (for compatibility w/ complex numbers)
+   {
+      return value;
+   }
+
+   inline Real Real :: inv( void ) const
+   // returns inverse
+   {
+      return 1. / value;
+   }
+
+   inline double Real :: norm( void ) const
+   // returns norm
+   {
+      return std::fabs( value );
+   }
+
+   constexpr double Real :: norm2( void ) const
+   // returns norm squared
+   {
+      return value * value;
+   }
+
+   inline Real Real :: unit( void ) const
+   // returns number with unit norm and same sign
+   {
+      return value / norm();
+   }
+}
+
@@ -0,0 +1,105 @@
+// -----------------------------------------------------------------------------
+// libDDG -- MulticolorGaussSeidel.h
+// -----------------------------------------------------------------------------
+//
+// MulticolorGaussSeidel performs Gauss-Seidel (or SOR) relaxation for a
+// positive-definite (real symmetric or complex Hermitian) matrix, ordering the
+// unknowns by a coloring of its sparsity pattern (see GraphColoring.h).  Since
+// unknowns of the same color are not coupled, each color class is updated in
+// parallel; colors are visited in increasing order by a forward sweep and in
+// decreasing order by a backward sweep, so a forward sweep followed by a
+// backward sweep is a symmetric operator.  It may be used as a (slowly
+// converging) iterative solver,
+//
+//    MulticolorGaussSeidel<Real> S;
+//    S.build( A );
+//    S.solve( x, b );
+//
+// or as a smoother; Multigrid uses multicolorSweep() on every level.  A mesh
+// coloring may be supplied when the rows of A correspond to mesh vertices:
+//
+//    GraphColoring coloring;
+//    coloring.build( mesh );
+//    S.build( A, coloring );
+//
+
+#ifndef DDG_MULTICOLORGAUSSSEIDEL_H
+#define DDG_MULTICOLORGAUSSSEIDEL_H
+
+#include <cholmod.h>
+#include "Types.h"
+#include "SparseMatrix.h"
+#include "DenseMatrix.h"
+#include "GraphColoring.h"
+#include "ThreadPool.h"
+
+namespace DDG
+{
+   template <class T>
+   class MulticolorGaussSeidel
+   {
+      public:
+         MulticolorGaussSeidel( void );
+         // constructs an empty solver
+
+         ~MulticolorGaussSeidel( void );
+         // destructor
+
+         void build( SparseMatrix<T>& A );
+         // stores a copy of A and colors its sparsity pattern
+
+         void build( SparseMatrix<T>& A, const GraphColoring& coloring );
+         // stores a copy of A, whose unknowns are colored by coloring
+
+         void sweep( DenseMatrix<T>& x, const DenseMatrix<T>& b, bool forward = true ) const;
+         // applies one forward or backward relaxation sweep for Ax = b
+
+         int solve( DenseMatrix<T>& x, const DenseMatrix<T>& b );
+         // applies symmetric sweeps (forward, then backward) until the residual
+         // drops below tolerance; if x already has the same size as b it is used
+         // as an initial guess.  Returns the number of symmetric sweeps applied
+
+         double omega;
+         // relaxation parameter in (0,2); 1 gives Gauss-Seidel (default: 1)
+
+         int nThreads;
+         // number of threads per color (default: 0, one per processor)
+
+         int maxIterations;
+         // maximum number of symmetric sweeps per solve (default: 1000)
+
+         double tolerance;
+         // iteration stops once |b-Ax|_2 / |b|_2 falls below this value (default: 1e-10)
+
+      protected:
+         double residualNorm( const DenseMatrix<T>& x, const DenseMatrix<T>& b ) const;
+         // returns |b-Ax|_2
+
+         cholmod_sparse* A;
+         // copy of the system matrix
+
+         GraphColoring coloring;
+         // coloring of the unknowns
+
+      private:
+         MulticolorGaussSeidel( const MulticolorGaussSeidel& );
+         const MulticolorGaussSeidel& operator=( const MulticolorGaussSeidel& );
+         // copying is not supported
+   };
+
+   template <class T>
+   void multicolorSweep( const cholmod_sparse* A,
+                         const GraphColoring& coloring,
+                         DenseMatrix<T>& x,
+                         const DenseMatrix<T>& b,
+                         bool forward = true,
+                         double omega = 1.,
+                         int nThreads = 0 );
+   // applies one forward or backward relaxation sweep for Ax = b, where A is
+   // Hermitian in full compressed-column storage; small color classes are
+   // processed on the calling thread
+}
+
+#include "MulticolorGaussSeidel.inl"
+
+#endif
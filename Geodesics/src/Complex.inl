@@ -0,0 +1,189 @@
+#include <iostream>
+#include <cmath>
+
+#include "Complex.h"
+
+namespace DDG
+{
+   constexpr Complex::Complex( double a, double b )
+   // constructs number a+bi
+   : re( a ), im( b )
+   {}
+
+   inline void Complex::operator+=( const Complex& z )
+   // add z
+   {
+      re += z.re;
+      im += z.im;
+   }
+
+   inline void Complex::operator-=( const Complex& z )
+   // subtract z
+   {
+      re -= z.re;
+      im -= z.im;
+   }
+
+   inline void Complex::operator*=( const Complex& z )
+   // Complex multiply by z
+   {
+      double a = re;
+      double b = im;
+      double c = z.re;
+      double d = z.im;
+
+      re = a*c-b*d;
+      im = a*d+b*c;
+   }
+
+   inline void Complex::operator*=( double r )
+   // scalar multiply by r
+   {
+      re *= r;
+      im *= r;
+   }
+
+   inline void Complex::operator/=( double r )
+   // scalar divide by r
+   {
+      re /= r;
+      im /= r;
+   }
+
+   inline void Complex::operator/=( const Complex& z )
+   // scalar divide by r
+   {
+      *this *= z.inv();
+   }
+
+   constexpr Complex Complex::operator-( void ) const
+   {
+      return Complex( -re, -im );
+   }
+
+   constexpr Complex Complex::conj( void ) const
+   // returns Complex conjugate
+   {
+      return Complex( re, -im );
+   }
+
+   inline Complex Complex::inv( void ) const
+   // returns inverse
+   {
+      return this->conj() / this->norm2();
+   }
+
+   inline double Complex::arg( void ) const
+   // returns argument
+   {
+      return std::atan2( im, re );
+   }
+
+   inline double Complex::norm( void ) const
+   // returns norm
+   {
+      return std::sqrt( re*re + im*im );
+   }
+
+   constexpr double Complex::norm2( void ) const
+   // returns norm squared
+   {
+      return re*re + im*im;
+   }
+
+   inline Complex Complex::unit( void ) const
+   // returns complex number with unit norm and same modulus
+   {
+      return *this / this->norm();
+   }
+
+   inline Complex Complex::exponential( void ) const
+   // complex exponentiation
+   {
+      return std::exp( re ) * Complex( std::cos( im ), std::sin( im ));
+   }
+
+   inline Complex operator+( const Complex& z1, const Complex& z2 )
+   // binary addition
+   {
+      Complex z = z1;
+      z += z2;
+      return z;
+   }
+
+   inline Complex operator-( const Complex& z1, const Complex& z2 )
+   // binary subtraction
+   {
+      Complex z = z1;
+      z -= z2;
+      return z;
+   }
+
+   inline Complex operator*( const Complex& z1, const Complex& z2 )
+   // binary Complex multiplication
+   {
+      Complex z = z1;
+      z *= z2;
+      return z;
+   }
+
+   inline Complex operator*( const Complex& z, double r )
+   // right scalar multiplication
+   {
+      Complex zr = z;
+      zr *= r;
+      return zr;
+   }
+
+   inline Complex operator*( double r, const Complex& z )
+   // left scalar multiplication
+   {
+      return z*r;
+   }
+
+   inline Complex operator/( const Complex& z, double r )
+   // scalar division
+   {
+      Complex zr = z;
+      zr /= r;
+      return zr;
+   }
+
+   inline Complex operator/( const Complex& z1, const Complex& z2 )
+   // complex division
+   {
+      Complex z = z1;
+      z /= z2;
+      return z;
+   }
+
+   constexpr double dot( const Complex& z1, const Complex& z2 )
+   {
+      return z1.re*z2.re + z1.im*z2.im;
+   }
+
+   constexpr double cross( const Complex& z1, const Complex& z2 )
+   {
+      return z1.re*z2.im - z1.im*z2.re;
+   }
+
+   inline std::ostream& operator<<( std::ostream& os, const Complex& z )
+   // prints components
+   {
+      if( z.im > 0 )
+      {
+         os << z.re << " + " << z.im << "i";
+      }
+      else if( z.im < 0 )
+      {
+         os << z.re << " - " << -z.im << "i";
+      }
+      else
+      {
+         os << z.re;
+      }
+
+      return os;
+   }
+}
+
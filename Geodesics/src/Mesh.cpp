@@ -1,5 +1,6 @@
 #include <map>
 #include <fstream>
+#include <utility>
 #include "Mesh.h"
 #include "MeshIO.h"
 #include "DiscreteExteriorCalculus.h"
@@ -16,6 +17,11 @@ namespace DDG
       *this = mesh;
    }
    
+   Mesh :: Mesh( Mesh&& mesh )
+   {
+      *this = std::move( mesh );
+   }
+   
    class  HalfEdgeIterCompare { public: bool operator()( const  HalfEdgeIter& i, const  HalfEdgeIter& j ) const { return &*i < &*j; } };
    class HalfEdgeCIterCompare { public: bool operator()( const HalfEdgeCIter& i, const HalfEdgeCIter& j ) const { return &*i < &*j; } };
    class    VertexIterCompare { public: bool operator()( const    VertexIter& i, const    VertexIter& j ) const { return &*i < &*j; } };
@@ -68,6 +74,20 @@ namespace DDG
       return *this;
    }
    
+   const Mesh& Mesh :: operator=( Mesh&& mesh )
+   {
+      // moving a vector leaves its elements where they are, so the
+      // iterators stored in the elements remain valid
+      halfedges     = std::move( mesh.halfedges     );
+      vertices      = std::move( mesh.vertices      );
+      edges         = std::move( mesh.edges         );
+      faces         = std::move( mesh.faces         );
+      boundaries    = std::move( mesh.boundaries    );
+      inputFilename = std::move( mesh.inputFilename );
+      
+      return *this;
+   }
+   
    int Mesh::read( const string& filename )
    {
       inputFilename = filename;
@@ -0,0 +1,218 @@
+#include <algorithm>
+#include "MeshPartition.h"
+#include "LinearContext.h"
+#include "Mesh.h"
+
+using namespace std;
+
+namespace DDG
+{
+   extern LinearContext context;
+
+   inline void grow( cholmod_sparse* S, vector<UF_long>& partition, UF_long side, UF_long count )
+   // moves vertices of the other half into the given half of partition (0 or
+   // 1) until it has count vertices, taking neighbors of the half first so
+   // that it grows along the boundary between the halves
+   {
+      const UF_long* Sp = (const UF_long*) S->p;
+      const UF_long* Si = (const UF_long*) S->i;
+      UF_long m = S->ncol;
+
+      vector<UF_long> queue;
+      for( UF_long r = 0; r < m; r++ )
+      {
+         if( partition[r] == side ) queue.push_back( r );
+      }
+
+      UF_long size = queue.size();
+      for( size_t q = 0; q < queue.size() && size < count; q++ )
+      {
+         UF_long j = queue[q];
+         for( UF_long p = Sp[j]; p < Sp[j+1] && size < count; p++ )
+         {
+            UF_long i = Si[p];
+            if( partition[i] != side )
+            {
+               partition[i] = side;
+               queue.push_back( i );
+               size++;
+            }
+         }
+      }
+
+      // the other half may have components not adjacent to this one
+      for( UF_long r = 0; r < m && size < count; r++ )
+      {
+         if( partition[r] != side )
+         {
+            partition[r] = side;
+            size++;
+         }
+      }
+   }
+
+   void MeshPartition :: build( const Mesh& mesh, int k )
+   // splits the vertices of mesh into k subdomains
+   {
+      int nV = mesh.vertices.size();
+
+      // pattern of the vertex adjacency matrix (plus the diagonal)
+      vector< vector<UF_long> > neighbors( nV );
+      for( int i = 0; i < nV; i++ )
+      {
+         neighbors[i].push_back( i );
+      }
+      for( EdgeCIter e  = mesh.edges.begin();
+                     e != mesh.edges.end();
+                     e ++ )
+      {
+         int i = e->he->vertex->index;
+         int j = e->he->flip->vertex->index;
+         neighbors[i].push_back( j );
+         neighbors[j].push_back( i );
+      }
+
+      UF_long nnz = 0;
+      for( int i = 0; i < nV; i++ )
+      {
+         nnz += neighbors[i].size();
+      }
+
+      int sorted = true;
+      int packed = true;
+      int stype = 0;
+      cholmod_sparse* A = cholmod_l_allocate_sparse( nV, nV, nnz, sorted, packed, stype, CHOLMOD_PATTERN, context );
+      UF_long* Ap = (UF_long*) A->p;
+      UF_long* Ai = (UF_long*) A->i;
+      Ap[0] = 0;
+      for( int j = 0; j < nV; j++ )
+      {
+         sort( neighbors[j].begin(), neighbors[j].end() );
+         copy( neighbors[j].begin(), neighbors[j].end(), Ai + Ap[j] );
+         Ap[j+1] = Ap[j] + neighbors[j].size();
+      }
+
+      build( A, k );
+
+      cholmod_l_free_sparse( &A, context );
+   }
+
+   void MeshPartition :: build( cholmod_sparse* A, int k )
+   // splits the rows of the square matrix A into k subdomains
+   {
+      int n = A->ncol;
+      k = max( 1, min( k, n ));
+
+      parts.assign( n, 0 );
+      vector<UF_long> rows( n );
+      for( int i = 0; i < n; i++ )
+      {
+         rows[i] = i;
+      }
+      bisect( A, rows, 0, k );
+
+      // group vertices by subdomain
+      offsets.assign( k+1, 0 );
+      for( int i = 0; i < n; i++ )
+      {
+         offsets[ parts[i] + 1 ]++;
+      }
+      for( int s = 0; s < k; s++ )
+      {
+         offsets[s+1] += offsets[s];
+      }
+
+      members.resize( n );
+      vector<int> next( offsets.begin(), offsets.end()-1 );
+      for( int i = 0; i < n; i++ )
+      {
+         members[ next[ parts[i] ]++ ] = i;
+      }
+   }
+
+   void MeshPartition :: bisect( cholmod_sparse* A, const vector<UF_long>& rows, int firstPart, int nParts )
+   // assigns the given rows of A to subdomains firstPart through firstPart+nParts-1
+   {
+      if( nParts == 1 || rows.size() < 2 )
+      {
+         for( size_t r = 0; r < rows.size(); r++ )
+         {
+            parts[ rows[r] ] = firstPart;
+         }
+         return;
+      }
+
+      // the halves receive nLeft and nParts - nLeft subdomains; for all
+      // subdomains to have about the same size, the left half needs about
+      // m*nLeft/nParts vertices
+      int nLeft = nParts/2;
+      UF_long m = rows.size();
+      UF_long mLeft = max( (UF_long) 1, min( m-1, ( m * nLeft ) / nParts ));
+
+      // METIS node bisection of the subgraph; Partition is 0 or 1 for the two
+      // halves, and 2 for vertices on the separator
+      cholmod_sparse* S = cholmod_l_submatrix( A, (UF_long*) &rows[0], m, (UF_long*) &rows[0], m, false, true, context );
+      S->stype = 1;
+      vector<UF_long> partition( m );
+      UF_long nSeparator = cholmod_l_bisect( S, NULL, 0, true, &partition[0], context );
+
+      if( nSeparator < 0 )
+      {
+         // bisection is unavailable; split by index
+         for( UF_long r = 0; r < m; r++ )
+         {
+            partition[r] = r < mLeft ? 0 : 1;
+         }
+      }
+
+      // separator vertices join whichever half is smaller
+      UF_long count[2] = { 0, 0 };
+      for( UF_long r = 0; r < m; r++ )
+      {
+         if( partition[r] != 2 ) count[ partition[r] ]++;
+      }
+      for( UF_long r = 0; r < m; r++ )
+      {
+         if( partition[r] == 2 )
+         {
+            partition[r] = count[0] <= count[1] ? 0 : 1;
+            count[ partition[r] ]++;
+         }
+      }
+
+      // METIS splits evenly, which is right only for an even number of
+      // subdomains; otherwise move vertices across the boundary so that
+      // e.g. three subdomains get m/3 vertices each rather than m/2, m/4, m/4
+      if( count[0] < mLeft )
+      {
+         grow( S, partition, 0, mLeft );
+      }
+      else if( count[0] > mLeft )
+      {
+         grow( S, partition, 1, m - mLeft );
+      }
+      cholmod_l_free_sparse( &S, context );
+
+      vector<UF_long> left, right;
+      for( UF_long r = 0; r < m; r++ )
+      {
+         if( partition[r] == 0 ) left.push_back( rows[r] );
+         else                    right.push_back( rows[r] );
+      }
+
+      bisect( A, left,  firstPart,         nLeft );
+      bisect( A, right, firstPart + nLeft, nParts - nLeft );
+   }
+
+   int MeshPartition :: nParts( void ) const
+   // returns the number of subdomains
+   {
+      return offsets.empty() ? 0 : offsets.size() - 1;
+   }
+
+   int MeshPartition :: size( void ) const
+   // returns the number of vertices
+   {
+      return parts.size();
+   }
+}
@@ -0,0 +1,424 @@
+#include <cassert>
+#include <iostream>
+using namespace std;
+
+#include "Multigrid.h"
+#include "LinearContext.h"
+
+namespace DDG
+{
+   extern LinearContext context;
+
+   template <class T>
+   Multigrid<T> :: Multigrid( void )
+   : cycleType( vCycle ),
+     nSmooth( 2 ),
+     multicolor( true ),
+     maxIterations( 100 ),
+     tolerance( 1e-10 )
+   {}
+
+   template <class T>
+   Multigrid<T> :: ~Multigrid( void )
+   // destructor
+   {
+      clear();
+   }
+
+   template <class T>
+   void Multigrid<T> :: clear( void )
+   // releases all levels
+   {
+      for( size_t l = 0; l < operators.size(); l++ )
+      {
+         cholmod_l_free_sparse( &operators[l], context );
+      }
+      for( size_t l = 0; l < prolongations.size(); l++ )
+      {
+         cholmod_l_free_sparse( &prolongations[l], context );
+      }
+      operators.clear();
+      prolongations.clear();
+      colorings.clear();
+   }
+
+   template <class T>
+   bool Multigrid<T> :: valid( void ) const
+   // returns true if the solver has been built; false otherwise
+   {
+      return !operators.empty();
+   }
+
+   template <class T>
+   int Multigrid<T> :: nLevels( void ) const
+   // returns the number of levels in the hierarchy
+   {
+      return operators.size();
+   }
+
+   template <class T>
+   void Multigrid<T> :: build( const MeshHierarchy& hierarchy, SparseMatrix<T>& A )
+   // builds all coarse-level operators for the positive-definite matrix A
+   {
+      assert( A.nRows() == A.nColumns() );
+      assert( A.nRows() == hierarchy.size( 0 ));
+
+      clear();
+
+      Timer timer;
+      operators.push_back( cholmod_l_copy_sparse( A.to_cholmod(), context ));
+      for( int l = 0; l+1 < hierarchy.nLevels(); l++ )
+      {
+         cholmod_sparse* Al = operators[l];
+
+         prolongations.push_back( buildProlongation( Al, hierarchy.aggregates( l ), hierarchy.size( l+1 )));
+         colorings.push_back( GraphColoring() );
+         colorings.back().build( Al );
+
+         operators.push_back( galerkinProduct( Al, prolongations.back() ));
+      }
+
+      // only the (small) coarsest operator is copied back into a SparseMatrix
+      SparseMatrix<T> AL;
+      AL = cholmod_l_copy_sparse( operators.back(), context );
+      coarsest.build( AL );
+      if( !coarsest.valid() )
+      {
+         cerr << "Warning: could not factor the coarsest multigrid level; it will be smoothed instead." << endl;
+      }
+
+      SolverStats stats;
+      stats.solver = "mg setup";
+      timer.stop( stats );
+      stats.nnzA = cholmod_l_nnz( operators[0], context );
+      context.report( stats );
+      if( context.verbose )
+      {
+         cout << "[mg setup] levels: " << nLevels() << " (coarsest: " << AL.nRows() << ")" << "\n";
+      }
+   }
+
+   template <class T>
+   cholmod_sparse* Multigrid<T> :: buildProlongation( const cholmod_sparse* A,
+                                                      const std::vector<int>& agg,
+                                                      int nCoarse ) const
+   // returns P = (I - omega D^-1 A) P0, where P0 is the 0/1 cluster indicator
+   // matrix and D is the diagonal of A; omega = 2/3 is the usual damping for
+   // operators whose Jacobi-scaled spectral radius is about two (e.g., Laplacians)
+   {
+      const double omega = 2./3.;
+      const UF_long* Ap = (const UF_long*) A->p;
+      const UF_long* Ai = (const UF_long*) A->i;
+      const T*       Ax = (const T*)       A->x;
+      int n = A->ncol;
+
+      vector<T> diagonal( n, T( 0. ));
+      for( int j = 0; j < n; j++ )
+      {
+         for( UF_long p = Ap[j]; p < Ap[j+1]; p++ )
+         {
+            if( Ai[p] == j )
+            {
+               diagonal[j] = Ax[p];
+            }
+         }
+      }
+
+      // one triplet per vertex for P0, plus one per nonzero of A; duplicate
+      // entries are summed when the triplets are compressed
+      cholmod_triplet* P = cholmod_l_allocate_triplet( n, nCoarse, n + Ap[n], 0, A->xtype, context );
+      UF_long* Pi = (UF_long*) P->i;
+      UF_long* Pj = (UF_long*) P->j;
+      T*       Px = (T*)       P->x;
+      UF_long k = 0;
+
+      for( int i = 0; i < n; i++ )
+      {
+         Pi[k] = i;
+         Pj[k] = agg[i];
+         Px[k] = T( 1. );
+         k++;
+      }
+      for( int j = 0; j < n; j++ )
+      {
+         for( UF_long p = Ap[j]; p < Ap[j+1]; p++ )
+         {
+            int i = Ai[p];
+
+            Pi[k] = i;
+            Pj[k] = agg[j];
+            Px[k] = -omega * ( Ax[p] / diagonal[i] );
+            k++;
+         }
+      }
+      P->nnz = k;
+
+      cholmod_sparse* Pc = cholmod_l_triplet_to_sparse( P, 0, context );
+      cholmod_l_free_triplet( &P, context );
+
+      return Pc;
+   }
+
+   template <class T>
+   cholmod_sparse* Multigrid<T> :: galerkinProduct( cholmod_sparse* A, cholmod_sparse* P ) const
+   // returns the coarse-level operator P^H A P
+   {
+      cholmod_sparse* AP = cholmod_l_ssmult( A, P, 0, true, true, context );
+      cholmod_sparse* PH = cholmod_l_transpose( P, 2, context );
+      cholmod_sparse* Ac = cholmod_l_ssmult( PH, AP, 0, true, true, context );
+
+      cholmod_l_free_sparse( &AP, context );
+      cholmod_l_free_sparse( &PH, context );
+
+      return Ac;
+   }
+
+   template <class T>
+   void Multigrid<T> :: solve( DenseMatrix<T>& x, const DenseMatrix<T>& b )
+   // solves Ax = b
+   {
+      SolverStats stats;
+      solve( x, b, stats );
+      context.report( stats );
+   }
+
+   template <class T>
+   void Multigrid<T> :: solve( DenseMatrix<T>& x, const DenseMatrix<T>& b, SolverStats& stats )
+   // solves Ax = b, storing (but not reporting) the statistics of the solve in stats
+   {
+      assert( valid() );
+      assert( b.nRows() == (int) operators[0]->nrow );
+
+      if( &x == &b )
+      {
+         DenseMatrix<T> bCopy( b );
+         solve( x, bCopy, stats );
+         return;
+      }
+
+      Timer timer;
+      stats.clear();
+      stats.solver = "mg";
+      stats.nnzA = cholmod_l_nnz( operators[0], context );
+
+      if( x.nRows() != b.nRows() || x.nColumns() != b.nColumns() )
+      {
+         x = DenseMatrix<T>( b.nRows(), b.nColumns() );
+      }
+
+      double bNorm = b.norm( lTwo );
+      if( bNorm == 0. )
+      {
+         x.zero();
+         timer.stop( stats );
+         stats.iterations = 0;
+         stats.residual = 0.;
+         return;
+      }
+
+      int iter = 0;
+      double relativeResidual = 1.;
+      DenseMatrix<T> r;
+      while( iter < maxIterations )
+      {
+         cycle( 0, x, b );
+         iter++;
+
+         residual( 0, x, b, r );
+         relativeResidual = r.norm( lTwo ) / bNorm;
+         if( relativeResidual < tolerance ) break;
+      }
+
+      timer.stop( stats );
+      stats.iterations = iter;
+      stats.residual = relativeResidual;
+   }
+
+   template <class T>
+   void Multigrid<T> :: cycle( int level, DenseMatrix<T>& x, const DenseMatrix<T>& b )
+   // applies one cycle on the specified level
+   {
+      int L = nLevels() - 1;
+
+      if( level == L )
+      {
+         if( coarsest.valid() )
+         {
+            DenseMatrix<T> bL( b );
+            backsolvePositiveDefinite( coarsest, x, bL );
+         }
+         else
+         {
+            for( int k = 0; k < 4*nSmooth; k++ )
+            {
+               smooth( level, x, b, true );
+               smooth( level, x, b, false );
+            }
+         }
+         return;
+      }
+
+      for( int k = 0; k < nSmooth; k++ )
+      {
+         smooth( level, x, b, true );
+      }
+
+      DenseMatrix<T> r;
+      residual( level, x, b, r );
+
+      int nCoarse = operators[level+1]->nrow;
+      DenseMatrix<T> bc( nCoarse, b.nColumns() );
+      DenseMatrix<T> xc( nCoarse, b.nColumns() );
+      restriction( level, r, bc );
+
+      int nVisits = ( cycleType == wCycle && level+1 < L ) ? 2 : 1;
+      for( int k = 0; k < nVisits; k++ )
+      {
+         cycle( level+1, xc, bc );
+      }
+
+      prolongate( level, xc, x );
+
+      for( int k = 0; k < nSmooth; k++ )
+      {
+         smooth( level, x, b, false );
+      }
+   }
+
+   template <class T>
+   void Multigrid<T> :: smooth( int level, DenseMatrix<T>& x, const DenseMatrix<T>& b, bool forward ) const
+   // applies one forward or backward Gauss-Seidel sweep; since A is Hermitian,
+   // row i of A is the conjugate of the (compressed) column i
+   {
+      // (the coarsest level has no coloring, and is only smoothed if it
+      // could not be factored)
+      if( multicolor && level < (int) colorings.size() )
+      {
+         multicolorSweep( operators[level], colorings[level], x, b, forward );
+         return;
+      }
+
+      const cholmod_sparse* A = operators[level];
+      const UF_long* Ap = (const UF_long*) A->p;
+      const UF_long* Ai = (const UF_long*) A->i;
+      const T*       Ax = (const T*)       A->x;
+      int n = A->ncol;
+
+      for( int c = 0; c < b.nColumns(); c++ )
+      {
+         for( int k = 0; k < n; k++ )
+         {
+            int i = forward ? k : n-1-k;
+
+            T sum = b( i, c );
+            T diagonal = 0.;
+            for( UF_long p = Ap[i]; p < Ap[i+1]; p++ )
+            {
+               int j = Ai[p];
+               if( j == i )
+               {
+                  diagonal = Ax[p];
+               }
+               else
+               {
+                  sum -= Ax[p].conj() * x( j, c );
+               }
+            }
+
+            x( i, c ) = sum / diagonal;
+         }
+      }
+   }
+
+   template <class T>
+   void Multigrid<T> :: residual( int level, const DenseMatrix<T>& x, const DenseMatrix<T>& b, DenseMatrix<T>& r ) const
+   // computes r = b - Ax
+   {
+      const cholmod_sparse* A = operators[level];
+      const UF_long* Ap = (const UF_long*) A->p;
+      const UF_long* Ai = (const UF_long*) A->i;
+      const T*       Ax = (const T*)       A->x;
+      int n = A->ncol;
+
+      r = b;
+      for( int c = 0; c < b.nColumns(); c++ )
+      {
+         for( int j = 0; j < n; j++ )
+         {
+            T xj = x( j, c );
+            for( UF_long p = Ap[j]; p < Ap[j+1]; p++ )
+            {
+               r( Ai[p], c ) -= Ax[p] * xj;
+            }
+         }
+      }
+   }
+
+   template <class T>
+   void Multigrid<T> :: restriction( int level, const DenseMatrix<T>& r, DenseMatrix<T>& rc ) const
+   // computes rc = P^H r
+   {
+      const cholmod_sparse* P = prolongations[level];
+      const UF_long* Pp = (const UF_long*) P->p;
+      const UF_long* Pi = (const UF_long*) P->i;
+      const T*       Px = (const T*)       P->x;
+      int nCoarse = P->ncol;
+
+      for( int c = 0; c < r.nColumns(); c++ )
+      {
+         for( int J = 0; J < nCoarse; J++ )
+         {
+            T sum = 0.;
+            for( UF_long p = Pp[J]; p < Pp[J+1]; p++ )
+            {
+               sum += Px[p].conj() * r( Pi[p], c );
+            }
+            rc( J, c ) = sum;
+         }
+      }
+   }
+
+   template <class T>
+   void Multigrid<T> :: prolongate( int level, const DenseMatrix<T>& xc, DenseMatrix<T>& x ) const
+   // computes x += P xc
+   {
+      const cholmod_sparse* P = prolongations[level];
+      const UF_long* Pp = (const UF_long*) P->p;
+      const UF_long* Pi = (const UF_long*) P->i;
+      const T*       Px = (const T*)       P->x;
+      int nCoarse = P->ncol;
+
+      for( int c = 0; c < x.nColumns(); c++ )
+      {
+         for( int J = 0; J < nCoarse; J++ )
+         {
+            T xJ = xc( J, c );
+            for( UF_long p = Pp[J]; p < Pp[J+1]; p++ )
+            {
+               x( Pi[p], c ) += Px[p] * xJ;
+            }
+         }
+      }
+   }
+
+   template <class T>
+   void solvePositiveDefinite( Multigrid<T>& M,
+                               DenseMatrix<T>& x,
+                               DenseMatrix<T>& b )
+   // solves the positive definite sparse linear system Ax = b using geometric multigrid
+   {
+      M.solve( x, b );
+   }
+
+   template <class T>
+   void solvePositiveDefinite( const MeshHierarchy& hierarchy,
+                               SparseMatrix<T>& A,
+                               DenseMatrix<T>& x,
+                               DenseMatrix<T>& b )
+   // solves the positive definite sparse linear system Ax = b using geometric multigrid
+   {
+      Multigrid<T> M;
+      M.build( hierarchy, A );
+      M.solve( x, b );
+   }
+}
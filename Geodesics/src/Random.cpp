@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <vector>
+#include <stdint.h>
+using namespace std;
+
+#include "Random.h"
+#include "ThreadPool.h"
+
+namespace DDG
+{
+   const long randomBlockSize = 16384;
+   // number of entries filled by each task
+
+   const long parallelFillSize = 262144;
+   // arrays with fewer entries than this are filled on the calling thread
+
+   inline void philox( uint64_t seed, uint64_t block, double u[2] )
+   // computes the two numbers in [0,1) with counter value block, using ten
+   // rounds of the Philox4x32 bijection keyed by seed
+   {
+      uint32_t c0 = (uint32_t) block, c1 = (uint32_t)( block >> 32 ), c2 = 0, c3 = 0;
+      uint32_t k0 = (uint32_t) seed,  k1 = (uint32_t)( seed  >> 32 );
+
+      for( int round = 0; round < 10; round++ )
+      {
+         uint64_t p0 = (uint64_t) 0xD2511F53u * c0;
+         uint64_t p1 = (uint64_t) 0xCD9E8D57u * c2;
+
+         c0 = (uint32_t)( p1 >> 32 ) ^ c1 ^ k0;
+         c1 = (uint32_t) p1;
+         c2 = (uint32_t)( p0 >> 32 ) ^ c3 ^ k1;
+         c3 = (uint32_t) p0;
+
+         k0 += 0x9E3779B9u;
+         k1 += 0xBB67AE85u;
+      }
+
+      // keep the top 53 bits of each 64-bit half
+      const double scale = 1. / 9007199254740992.; // 2^-53
+      u[0] = scale * (double)( ( ( (uint64_t) c0 << 32 ) | c1 ) >> 11 );
+      u[1] = scale * (double)( ( ( (uint64_t) c2 << 32 ) | c3 ) >> 11 );
+   }
+
+   void generate( uint64_t seed, uint64_t first, double* x, long n, double a, double s )
+   // stores a + s*u_i in x[i], where u_i is number first+i of the stream
+   {
+      double u[2];
+      long i = 0;
+
+      // each counter value yields two consecutive numbers
+      if( n > 0 && first % 2 == 1 )
+      {
+         philox( seed, first/2, u );
+         x[i++] = a + s*u[1];
+      }
+      for( ; i+1 < n; i += 2 )
+      {
+         philox( seed, (first+i)/2, u );
+         x[i+0] = a + s*u[0];
+         x[i+1] = a + s*u[1];
+      }
+      if( i < n )
+      {
+         philox( seed, (first+i)/2, u );
+         x[i] = a + s*u[0];
+      }
+   }
+
+   class RandomBlock : public ThreadPool::Task
+   {
+      public:
+         RandomBlock( uint64_t seed_, uint64_t first_, double* x_, long n_, double a_, double s_ )
+         : seed( seed_ ), first( first_ ), x( x_ ), n( n_ ), a( a_ ), s( s_ )
+         {}
+
+         virtual void run( void )
+         {
+            generate( seed, first, x, n, a, s );
+         }
+
+      protected:
+         uint64_t seed;
+         uint64_t first;
+         double* x;
+         long n;
+         double a;
+         double s;
+   };
+
+   Random :: Random( unsigned long seed_ )
+   // constructs the stream of numbers determined by seed
+   : key( seed_ ),
+     counter( 0 )
+   {}
+
+   Random :: Random( const Random& rng )
+   // copies the seed and position of rng
+   : key( rng.key ),
+     counter( rng.counter.load() )
+   {}
+
+   const Random& Random :: operator=( const Random& rng )
+   // copies the seed and position of rng
+   {
+      key = rng.key;
+      counter = rng.counter.load();
+
+      return *this;
+   }
+
+   void Random :: seed( unsigned long seed_ )
+   // restarts the stream determined by seed from the beginning
+   {
+      key = seed_;
+      counter = 0;
+   }
+
+   unsigned long Random :: position( void ) const
+   // returns the number of values drawn so far
+   {
+      return counter;
+   }
+
+   double Random :: uniform( void )
+   // returns the next number in [0,1)
+   {
+      return value( key, counter.fetch_add( 1 ));
+   }
+
+   double Random :: uniform( double a, double b )
+   // returns the next number, scaled to [a,b)
+   {
+      return a + (b-a)*uniform();
+   }
+
+   void Random :: fill( double* x, long n, double a, double b, int nThreads )
+   // stores the next n numbers, scaled to [a,b), in x[0], ..., x[n-1]
+   {
+      // reserve counter values first, ..., first+n-1 for this call
+      unsigned long first = counter.fetch_add( n );
+
+      if( nThreads == 1 || n < parallelFillSize )
+      {
+         generate( key, first, x, n, a, b-a );
+      }
+      else
+      {
+         vector<ThreadPool::Task*> tasks;
+         for( long begin = 0; begin < n; begin += randomBlockSize )
+         {
+            long end = min( n, begin + randomBlockSize );
+            tasks.push_back( new RandomBlock( key, first+begin, x+begin, end-begin, a, b-a ));
+         }
+
+         ThreadPool pool( nThreads );
+         pool.run( tasks );
+
+         for( size_t k = 0; k < tasks.size(); k++ )
+         {
+            delete tasks[k];
+         }
+      }
+   }
+
+   double Random :: value( unsigned long seed, unsigned long index )
+   // returns number index of the stream determined by seed, in [0,1)
+   {
+      double u[2];
+      philox( seed, index/2, u );
+      return u[index%2];
+   }
+}
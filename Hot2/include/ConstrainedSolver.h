@@ -0,0 +1,95 @@
+// -----------------------------------------------------------------------------
+// libDDG -- ConstrainedSolver.h
+// -----------------------------------------------------------------------------
+//
+// ConstrainedSolver solves a positive-definite system Ax = b in which some of
+// the unknowns have prescribed (Dirichlet) values, e.g., boundary vertices or
+// handles selected by the user.  Writing f for the free unknowns and c for the
+// constrained ones, the remaining equations are
+//
+//    A_ff x_f = b_f - A_fc x_c.
+//
+// The reduced matrix A_ff is factored once when the set of constrained unknowns
+// is specified; afterwards, both the right-hand side and the constraint values
+// may change from one solve to the next at the cost of one sparse matrix-vector
+// product and one backsolve.  For example, to drag a set of handles:
+//
+//    SparseMatrix<Real> A;
+//    DenseMatrix<Real> x, b, values;
+//    std::vector<int> handles;
+//
+//    ConstrainedSolver<Real> solver;
+//    solver.build( A, handles );
+//
+//    // each frame, set values(k) to the new position of handles[k]
+//    solver.solve( x, b, values );
+//
+// The rows of b corresponding to constrained unknowns are ignored, and the
+// corresponding rows of x are set to the constraint values.  Multiple right-
+// hand sides may be solved at once by giving b and values several columns.
+//
+
+#ifndef DDG_CONSTRAINEDSOLVER_H
+#define DDG_CONSTRAINEDSOLVER_H
+
+#include <cholmod.h>
+#include <vector>
+#include "Types.h"
+#include "SparseMatrix.h"
+#include "DenseMatrix.h"
+
+namespace DDG
+{
+   template <class T>
+   class ConstrainedSolver
+   {
+      public:
+         ConstrainedSolver( void );
+         // constructs an empty solver
+
+         ~ConstrainedSolver( void );
+         // destructor
+
+         void build( SparseMatrix<T>& A, const std::vector<int>& constrained );
+         // extracts and factors the free-free block of the positive-definite
+         // matrix A, where constrained lists the indices of fixed unknowns
+
+         void solve( DenseMatrix<T>& x,
+                     const DenseMatrix<T>& b,
+                     const DenseMatrix<T>& values );
+         // solves Ax = b subject to x(constrained[k]) = values(k), where b has
+         // one row per unknown and values has one row per constrained unknown
+
+         bool valid( void ) const;
+         // returns true if the reduced system was factored successfully; false otherwise
+
+         int nFree( void ) const;
+         // returns the number of free unknowns
+
+         int nConstrained( void ) const;
+         // returns the number of constrained unknowns
+
+      protected:
+         void clear( void );
+         // releases the coupling block
+
+         std::vector<int> freeIndex;
+         // index of each unknown in the reduced system, or -1 if constrained
+
+         std::vector<int> freeUnknowns;
+         // unknowns of the original system that remain free
+
+         std::vector<int> constrainedUnknowns;
+         // unknowns of the original system that are fixed
+
+         cholmod_sparse* Afc;
+         // coupling block between free and constrained unknowns
+
+         SparseFactor<T> factor;
+         // Cholesky factor of the free-free block
+   };
+}
+
+#include "ConstrainedSolver.inl"
+
+#endif
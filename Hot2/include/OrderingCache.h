@@ -0,0 +1,118 @@
+// -----------------------------------------------------------------------------
+// libDDG -- OrderingCache.h
+// -----------------------------------------------------------------------------
+//
+// OrderingCache stores fill-reducing permutations computed by sparse
+// factorizations, keyed by a hash of the sparsity pattern of the factored
+// matrix and by the ordering method that produced them.  Since operators built
+// from the same mesh always have the same pattern, any later factorization of a
+// matrix on that mesh can skip the (often expensive) ordering step.  The global
+// LinearContext holds a cache that is used automatically by SparseFactor,
+// solvePositiveDefinite, solveSymmetric, and solveLU; it can be saved next to
+// the mesh so that subsequent runs start with a warm cache:
+//
+//    extern LinearContext context;
+//    std::string filename = OrderingCache::filename( "bunny.obj" );
+//
+//    context.orderings.read( filename );
+//    // ...factor some matrices...
+//    context.orderings.write( filename );
+//
+// Orderings are stored under the method that actually produced them (e.g., an
+// AMD fallback for an unavailable METIS is stored as such), and orderings read
+// from a file are checked to be permutations of the right length.  A hash
+// collision can therefore only produce a suboptimal ordering, not an invalid
+// one; LinearContext::analyze() also discards any cached ordering that CHOLMOD
+// rejects and computes a new one.
+// All operations are serialized by a mutex, so a single cache may be shared by
+// solves running on different threads.
+//
+
+#ifndef DDG_ORDERINGCACHE_H
+#define DDG_ORDERINGCACHE_H
+
+#include <cholmod.h>
+#include <pthread.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace DDG
+{
+   enum OrderingMethod
+   {
+      orderAuto,             // let CHOLMOD / UMFPACK choose (AMD, trying METIS if fill is high)
+      orderAMD,              // approximate minimum degree
+      orderMETIS,            // METIS nested dissection
+      orderNestedDissection  // CHOLMOD's own nested dissection (METIS + constrained AMD)
+   };
+
+   class OrderingCache
+   {
+      public:
+         OrderingCache( void );
+         // constructs an empty cache
+
+         ~OrderingCache( void );
+         // destructor
+
+         bool find( cholmod_sparse* A, OrderingMethod method, std::vector<UF_long>& perm ) const;
+         // if an ordering of A computed by the given method has been stored,
+         // copies it into perm and returns true; returns false otherwise
+
+         void insert( cholmod_sparse* A, OrderingMethod method, const UF_long* perm );
+         // stores the ordering perm (of length A->ncol) for matrix A
+
+         void erase( cholmod_sparse* A, OrderingMethod method );
+         // removes the ordering of A computed by the given method, if any
+
+         void clear( void );
+         // removes all orderings
+
+         int size( void ) const;
+         // returns the number of stored orderings
+
+         int read( const std::string& filename );
+         // adds all orderings stored in the given file; entries that are not
+         // permutations are skipped; return value is nonzero only if there
+         // was an error (including skipped entries)
+
+         int write( const std::string& filename ) const;
+         // writes all stored orderings to the given file; return value is
+         // nonzero only if there was an error
+
+         static std::string filename( const std::string& meshFilename );
+         // returns the conventional cache file name for a mesh file
+
+      protected:
+         class Key
+         {
+            public:
+               bool operator<( const Key& k ) const;
+
+               long n;
+               long nnz;
+               unsigned long hash;
+               int method;
+         };
+
+         static bool isPermutation( const std::vector<UF_long>& perm );
+         // returns true if perm contains each of 0, ..., perm.size()-1 exactly once
+
+         static Key key( cholmod_sparse* A, OrderingMethod method );
+         // computes the lookup key for A (size, number of nonzeros, and
+         // a hash of the symmetry type, column pointers, and row indices)
+
+         std::map< Key, std::vector<UF_long> > entries;
+
+         mutable pthread_mutex_t mutex;
+         // serializes access to entries
+
+      private:
+         OrderingCache( const OrderingCache& );
+         const OrderingCache& operator=( const OrderingCache& );
+         // copying is not supported
+   };
+}
+
+#endif
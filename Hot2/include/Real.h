@@ -6,10 +6,10 @@ namespace DDG
    class Real
    {
       public:
-         Real( double x = 0. );
+         constexpr Real( double x = 0. );
          // constructs real number with value x
 
-         operator double( void ) const;
+         constexpr operator double( void ) const;
          // type cast to double
 
          void operator+=( double x );
@@ -24,7 +24,7 @@ namespace DDG
          void operator/=( double x );
          // divide
 
-         Real conj( void ) const;
+         constexpr Real conj( void ) const;
          // simply returns the value (for compatibility w/ complex numbers)
 
          Real inv( void ) const;
@@ -33,7 +33,7 @@ namespace DDG
          double norm( void ) const;
          // returns norm
 
-         double norm2( void ) const;
+         constexpr double norm2( void ) const;
          // returns norm squared
 
          Real unit( void ) const;
@@ -45,4 +45,6 @@ namespace DDG
    };
 }
 
+#include "Real.inl"
+
 #endif
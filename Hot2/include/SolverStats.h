@@ -0,0 +1,116 @@
+// -----------------------------------------------------------------------------
+// libDDG -- SolverStats.h
+// -----------------------------------------------------------------------------
+//
+// SolverStats records what happened during the most recent call to one of the
+// sparse solvers (solve, solveLU, solveSymmetric, solvePositiveDefinite,
+// smallestEig*, Multigrid, SparseFactor::build, ...).  Fields that do not apply
+// to a given solver are set to -1.  The record for the calling thread is kept
+// by the global LinearContext; it is also printed to stdout unless printing has
+// been switched off:
+//
+//    extern LinearContext context;
+//    context.verbose = false;
+//
+//    solvePositiveDefinite( A, x, b );
+//    const SolverStats& stats( context.stats() );
+//    std::cerr << "nnz(L): " << stats.nnzL << std::endl;
+//
+// Timer measures both wall-clock time and process CPU time.  Note that the CPU
+// time is summed over all threads of the process, so it may exceed the wall-
+// clock time when several solves run concurrently.
+//
+
+#ifndef DDG_SOLVERSTATS_H
+#define DDG_SOLVERSTATS_H
+
+#include <cholmod.h>
+#include <ctime>
+#include <ostream>
+#include <string>
+
+namespace DDG
+{
+   class SolverStats
+   {
+      public:
+         SolverStats( void );
+         // constructs an empty record
+
+         void clear( void );
+         // resets all fields
+
+         void factor( cholmod_sparse* A, cholmod_factor* L, cholmod_common* common );
+         // fills in nnzA, nnzL, flops, and ordering after a CHOLMOD factorization
+
+         void lu( long nnz, const double* info );
+         // fills in nnzA, nnzL, flops, and rank from an UMFPACK info array
+
+         void print( std::ostream& os ) const;
+         // writes all available fields, one per line, prefixed by the solver name
+
+         std::string solver;
+         // short name of the solver ("chol", "qr", "lu", "ldlt", "eig", "mg", ...)
+
+         double wallTime;
+         // elapsed wall-clock time, in seconds
+
+         double cpuTime;
+         // elapsed process CPU time, in seconds
+
+         long nnzA;
+         // number of stored nonzeros in the system matrix
+
+         double nnzL;
+         // number of nonzeros in the factor(s) (L for Cholesky/LDL', L+U for LU, R for QR)
+
+         double flops;
+         // floating point operations performed by the factorization
+
+         int ordering;
+         // fill-reducing ordering actually used (CHOLMOD_AMD, CHOLMOD_METIS, ...)
+
+         long rank;
+         // numerical rank (QR and LU only)
+
+         int iterations;
+         // number of iterations (iterative solvers only)
+
+         double residual;
+         // max residual of the solution (see residual() in SparseMatrix.h)
+
+         double predictedMemory;
+         // size of the Cholesky factor predicted by the solver planner, in bytes
+
+         double predictedTime;
+         // Cholesky factorization time predicted by the solver planner, in seconds
+
+         static const char* orderingName( int ordering );
+         // returns a human-readable name for a CHOLMOD ordering constant
+   };
+
+   class Timer
+   {
+      public:
+         Timer( void );
+         // constructs a timer and starts it
+
+         void start( void );
+         // restarts the timer
+
+         double wallTime( void ) const;
+         // returns wall-clock seconds elapsed since the timer was started
+
+         double cpuTime( void ) const;
+         // returns process CPU seconds elapsed since the timer was started
+
+         void stop( SolverStats& stats ) const;
+         // stores the elapsed times in stats
+
+      protected:
+         double wall0;
+         clock_t cpu0;
+   };
+}
+
+#endif
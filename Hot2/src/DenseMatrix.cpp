@@ -1,67 +1,213 @@
+#include <cmath>
+using namespace std;
+
 #include "DenseMatrix.h"
+#include "Random.h"
+#include "Reduction.h"
+
+extern "C"
+{
+   // Fortran BLAS routines (provided by DDG_BLAS_LIBS)
+   void dgemm_( const char* transA, const char* transB, const int* m, const int* n, const int* k,
+                const double* alpha, const double* A, const int* lda, const double* B, const int* ldb,
+                const double* beta, double* C, const int* ldc );
+   void zgemm_( const char* transA, const char* transB, const int* m, const int* n, const int* k,
+                const double* alpha, const double* A, const int* lda, const double* B, const int* ldb,
+                const double* beta, double* C, const int* ldc );
+   void dgemv_( const char* trans, const int* m, const int* n,
+                const double* alpha, const double* A, const int* lda, const double* x, const int* incx,
+                const double* beta, double* y, const int* incy );
+   void zgemv_( const char* trans, const int* m, const int* n,
+                const double* alpha, const double* A, const int* lda, const double* x, const int* incx,
+                const double* beta, double* y, const int* incy );
+}
 
 namespace DDG
 {
-   template <>
-   cholmod_dense* DenseMatrix<Real> :: to_cholmod( void )
-   // returns pointer to underlying cholmod_dense data structure
+   const long smallProductSize = 4096;
+   // products with fewer multiply-adds than this skip the BLAS call overhead
+
+   void gemm( int m, int n, int l, const Real* A, const Real* B, Real* C )
+   // accumulates C += A*B using BLAS; Real has the same layout as double
    {
-      if( cData )
+      if( (long) m * n * l < smallProductSize )
       {
-         cholmod_l_free_dense( &cData, context );
-         cData = NULL;
+         // run the blocked kernel on plain doubles so that it vectorizes
+         gemm<double>( m, n, l, (const double*) A, (const double*) B, (double*) C );
+         return;
       }
 
-      int d = m; // leading dimension
-      cData = cholmod_l_allocate_dense( m, n, d, CHOLMOD_REAL, context );
-      double* x = (double*) cData->x;
+      const double one = 1.;
+      const int inc = 1;
+      if( n == 1 )
+      {
+         dgemv_( "N", &m, &l, &one, (const double*) A, &m, (const double*) B, &inc, &one, (double*) C, &inc );
+      }
+      else
+      {
+         dgemm_( "N", "N", &m, &n, &l, &one, (const double*) A, &m, (const double*) B, &l, &one, (double*) C, &m );
+      }
+   }
 
-      for( int i = 0; i < m*n; i++ )
+   void gemm( int m, int n, int l, const Complex* A, const Complex* B, Complex* C )
+   // accumulates C += A*B using BLAS; Complex has the same layout as
+   // an interleaved pair of doubles
+   {
+      if( (long) m * n * l < smallProductSize )
       {
-         x[i] = data[i];
+         gemm<Complex>( m, n, l, A, B, C );
+         return;
       }
 
-      return cData;
+      const double one[2] = { 1., 0. };
+      const int inc = 1;
+      if( n == 1 )
+      {
+         zgemv_( "N", &m, &l, one, (const double*) A, &m, (const double*) B, &inc, one, (double*) C, &inc );
+      }
+      else
+      {
+         zgemm_( "N", "N", &m, &n, &l, one, (const double*) A, &m, (const double*) B, &l, one, (double*) C, &m );
+      }
    }
 
-   template <>
-   cholmod_dense* DenseMatrix<Complex> :: to_cholmod( void )
-   // returns pointer to underlying cholmod_dense data structure
+   double reduceNorm( const Real* x, int n, NormType type )
    {
-      if( cData )
+      const double* a = (const double*) x;
+      int nThreads = context.reductionThreads;
+
+      double r = 0.;
+
+      if( type == lInfinity )
       {
-         cholmod_l_free_dense( &cData, context );
-         cData = NULL;
+         r = Reduction::maxAbs( a, n, nThreads );
+      }
+      else if( type == lOne )
+      {
+         r = Reduction::sumAbs( a, n, nThreads );
+      }
+      else if( type == lTwo )
+      {
+         r = sqrt( Reduction::sumSquares( a, n, nThreads ));
       }
 
-      int d = m; // leading dimension
-      cData = cholmod_l_allocate_dense( m, n, d, CHOLMOD_COMPLEX, context );
-      double* x = (double*) cData->x;
+      return r;
+   }
 
-      for( int i = 0; i < m*n; i++ )
+   double reduceNorm( const Complex* x, int n, NormType type )
+   {
+      const double* z = (const double*) x;
+      int nThreads = context.reductionThreads;
+
+      double r = 0.;
+
+      if( type == lInfinity )
+      {
+         r = Reduction::complexMaxAbs( z, n, nThreads );
+      }
+      else if( type == lOne )
       {
-         x[i*2+0] = data[i].re;
-         x[i*2+1] = data[i].im;
+         r = Reduction::complexSumAbs( z, n, nThreads );
+      }
+      else if( type == lTwo )
+      {
+         // squared modulus = sum of squared real and imaginary parts
+         r = sqrt( Reduction::sumSquares( z, 2*n, nThreads ));
       }
 
-      return cData;
+      return r;
+   }
+
+   Real reduceSum( const Real* x, int n )
+   {
+      return Reduction::sum( (const double*) x, n, context.reductionThreads );
+   }
+
+   Complex reduceSum( const Complex* x, int n )
+   {
+      double re, im;
+      Reduction::complexSum( (const double*) x, n, re, im, context.reductionThreads );
+      return Complex( re, im );
+   }
+
+   Real reduceInner( const Real* x, const Real* y, int n )
+   {
+      return Reduction::dot( (const double*) x,
+                             (const double*) y, n, context.reductionThreads );
+   }
+
+   Complex reduceInner( const Complex* x, const Complex* y, int n )
+   {
+      double re, im;
+      Reduction::complexDot( (const double*) x,
+                             (const double*) y, n, re, im, context.reductionThreads );
+      return Complex( re, im );
+   }
+
+   Real reduceInner( const Real* x, const Real* w, const Real* y, int n )
+   {
+      return Reduction::dot( (const double*) x,
+                             (const double*) w,
+                             (const double*) y, n, context.reductionThreads );
+   }
+
+   Complex reduceInner( const Complex* x, const Complex* w, const Complex* y, int n )
+   {
+      double re, im;
+      Reduction::complexDot( (const double*) x,
+                             (const double*) w,
+                             (const double*) y, n, re, im, context.reductionThreads );
+      return Complex( re, im );
+   }
+
+   void makeView( cholmod_dense& view, int m, int n, void* x, int xtype )
+   // fills in a cholmod_dense header describing existing m x n column-major storage
+   {
+      view.nrow = m;
+      view.ncol = n;
+      view.nzmax = m*n;
+      view.d = m;
+      view.x = x;
+      view.z = NULL;
+      view.xtype = xtype;
+      view.dtype = CHOLMOD_DOUBLE;
    }
 
    template <>
-   cholmod_dense* DenseMatrix<Quaternion> :: to_cholmod( void )
-   // returns pointer to underlying cholmod_dense data structure
+   cholmod_dense* DenseMatrix<Real> :: to_cholmod( void )
+   // returns pointer to a view of the matrix in CHOLMOD format;
+   // Real has the same layout as double
    {
-      assert( nColumns() == 1 );
+      makeView( view, m, n, data.empty() ? NULL : &data[0], CHOLMOD_REAL );
+      return &view;
+   }
+
+   template <>
+   cholmod_dense* DenseMatrix<Complex> :: to_cholmod( void )
+   // returns pointer to a view of the matrix in CHOLMOD format;
+   // Complex has the same layout as an interleaved pair of doubles
+   {
+      makeView( view, m, n, data.empty() ? NULL : &data[0], CHOLMOD_COMPLEX );
+      return &view;
+   }
 
+   template <>
+   cholmod_dense* DenseMatrix<Quaternion> :: to_cholmod( void )
+   // returns pointer to underlying cholmod_dense data structure; each
+   // column becomes a column of a 4m x n real matrix, with component k
+   // of entry i in row 4i+k
+   {
       if( cData )
       {
          cholmod_l_free_dense( &cData, context );
          cData = NULL;
       }
 
-      cData = cholmod_l_allocate_dense( m*4, 1, m*4, CHOLMOD_REAL, context );
+      cData = cholmod_l_allocate_dense( m*4, n, m*4, CHOLMOD_REAL, context );
       double* x = (double*) cData->x;
 
+      // since the columns of the expansion are contiguous, entry i+m*j
+      // lands in rows 4(i+m*j) through 4(i+m*j)+3 of the storage
       for( int i = 0; i < m*n; i++ )
       {
          for( int k = 0; k < 4; k++ )
@@ -85,18 +231,25 @@ namespace DDG
       {
          cholmod_l_free_dense( &cData, context );
       }
-      cData = B;
-      
-      m = cData->nrow;
-      n = cData->ncol;
+
+      m = B->nrow;
+      n = B->ncol;
       data.resize( m*n );
 
-      double* x = (double*) cData->x;
+      if( B == &view )
+      {
+         // the result was written directly into our own storage
+         return *this;
+      }
+
+      double* x = (double*) B->x;
       for( int i = 0; i < m*n; i++ )
       {
          data[i] = x[i];
       }
 
+      cholmod_l_free_dense( &B, context );
+
       return *this;
    }
 
@@ -112,19 +265,26 @@ namespace DDG
       {
          cholmod_l_free_dense( &cData, context );
       }
-      cData = B;
 
-      m = cData->nrow;
-      n = cData->ncol;
+      m = B->nrow;
+      n = B->ncol;
       data.resize( m*n );
 
-      double* x = (double*) cData->x;
+      if( B == &view )
+      {
+         // the result was written directly into our own storage
+         return *this;
+      }
+
+      double* x = (double*) B->x;
       for( int i = 0; i < m*n; i++ )
       {
          data[i] = Complex( x[i*2+0],
                             x[i*2+1] );
       }
 
+      cholmod_l_free_dense( &B, context );
+
       return *this;
    }
 
@@ -135,26 +295,25 @@ namespace DDG
    {
       assert( B );
       assert( B->xtype == CHOLMOD_REAL );
-      assert( B->ncol == 1 );
       assert( B->nrow%4 == 0 );
 
-      if( cData )
+      if( cData && cData != B )
       {
          cholmod_l_free_dense( &cData, context );
       }
       cData = B;
 
       m = cData->nrow/4;
-      n = 1;
+      n = cData->ncol;
       data.resize( m*n );
 
       double* x = (double*) cData->x;
+      int d = cData->d;
+      for( int j = 0; j < n; j++ )
       for( int i = 0; i < m; i++ )
       {
-         data[i] = Quaternion( x[i*4+0],
-                               x[i*4+1],
-                               x[i*4+2],
-                               x[i*4+3] );
+         const double* q = x + i*4 + d*j;
+         data[i+m*j] = Quaternion( q[0], q[1], q[2], q[3] );
       }
 
       return *this;
@@ -281,38 +440,56 @@ namespace DDG
       return os;
    }
 
+   template <>
+   void DenseMatrix<Real> :: randomize( Random& rng )
+   // replaces entries with uniformly distributed real random numbers in the interval [-1,1]
+   {
+      rng.fill( data.empty() ? NULL : (double*) &data[0], m*n, -1., 1., context.reductionThreads );
+   }
+
    template <>
    void DenseMatrix<Real> :: randomize( void )
    // replaces entries with uniformly distributed real random numbers in the interval [-1,1]
    {
-      for( int i = 0; i < m*n; i++ )
-      {
-         data[i] = 2.*unitRand() - 1.;
-      }
+      randomize( context.random );
+   }
+
+   template <>
+   void DenseMatrix<Complex> :: randomize( Random& rng )
+   // replaces entries with uniformly distributed real random numbers in the interval [-1,1]
+   {
+      // Complex has the same layout as an interleaved pair of doubles
+      rng.fill( data.empty() ? NULL : (double*) &data[0], 2*m*n, -1., 1., context.reductionThreads );
    }
 
    template <>
    void DenseMatrix<Complex> :: randomize( void )
    // replaces entries with uniformly distributed real random numbers in the interval [-1,1]
    {
-      for( int i = 0; i < m*n; i++ )
-      {
-         data[i].re = 2.*unitRand() - 1.;
-         data[i].im = 2.*unitRand() - 1.;
-      }
+      randomize( context.random );
    }
 
    template <>
-   void DenseMatrix<Quaternion> :: randomize( void )
+   void DenseMatrix<Quaternion> :: randomize( Random& rng )
    // replaces entries with uniformly distributed real random numbers in the interval [-1,1]
    {
+      vector<double> x( 4*m*n );
+      rng.fill( x.empty() ? NULL : &x[0], 4*m*n, -1., 1., context.reductionThreads );
+
       for( int i = 0; i < m*n; i++ )
       {
          for( int k = 0; k < 4; k++ )
          {
-            data[i][k] = 2.*unitRand() - 1.;
+            data[i][k] = x[i*4+k];
          }
       }
    }
+
+   template <>
+   void DenseMatrix<Quaternion> :: randomize( void )
+   // replaces entries with uniformly distributed real random numbers in the interval [-1,1]
+   {
+      randomize( context.random );
+   }
 }
 
@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <iostream>
+using namespace std;
+
 #include "LinearContext.h"
 
 namespace DDG
@@ -7,19 +11,250 @@ namespace DDG
 
    LinearContext :: LinearContext( void )
    // constructor
+   : verbose( true ),
+     residuals( residualDebug ),
+     residualInterval( 10 ),
+     reductionThreads( 0 ),
+     random( 0 ),
+     ordering( orderAuto )
    {
-      cholmod_l_start( &context );
+      pthread_key_create( &key, release );
+      pthread_mutex_init( &printMutex, NULL );
    }
 
    LinearContext :: ~LinearContext( void )
    // destructor
    {
-      cholmod_l_finish( &context );
+      // the key destructor is not called for the main thread
+      release( pthread_getspecific( key ));
+      pthread_setspecific( key, NULL );
+      pthread_key_delete( key );
+      pthread_mutex_destroy( &printMutex );
    }
 
    LinearContext :: operator cholmod_common*( void )
-   // allows LinearContext to be treated as a cholmod_common*
+   // allows LinearContext to be treated as a cholmod_common*; returns
+   // the cholmod_common belonging to the calling thread
+   {
+      return &state()->common;
+   }
+
+   SolverStats& LinearContext :: stats( void )
+   // returns the statistics of the most recent solve on the calling thread
+   {
+      return state()->stats;
+   }
+
+   void LinearContext :: report( const SolverStats& s )
+   // records s as the calling thread's most recent statistics
+   {
+      state()->stats = s;
+
+      if( verbose )
+      {
+         pthread_mutex_lock( &printMutex );
+         s.print( cout );
+         cout.flush();
+         pthread_mutex_unlock( &printMutex );
+      }
+   }
+
+   int LinearContext :: solve( int sys, cholmod_factor* L, cholmod_dense* B, cholmod_dense** X )
+   // solves a system with the factor L, reusing the calling thread's workspace
+   {
+      ThreadState* s = state();
+      return cholmod_l_solve2( sys, L, B, NULL, X, NULL, &s->Y, &s->E, &s->common );
+   }
+
+   bool LinearContext :: checkResidual( void )
+   // returns true if the current solve should compute its residual
+   {
+      switch( residuals )
+      {
+         case residualNever:
+            return false;
+         case residualAlways:
+            return true;
+         case residualSampled:
+            return state()->nSolves++ % max( residualInterval, 1 ) == 0;
+         default:
+#ifdef NDEBUG
+            return false;
+#else
+            return true;
+#endif
+      }
+   }
+
+   LinearContext::ThreadState* LinearContext :: state( void )
+   // returns the state of the calling thread, creating it if necessary
+   {
+      ThreadState* s = (ThreadState*) pthread_getspecific( key );
+
+      if( s == NULL )
+      {
+         s = new ThreadState;
+         s->nSolves = 0;
+         s->Y = NULL;
+         s->E = NULL;
+         cholmod_l_start( &s->common );
+         pthread_setspecific( key, s );
+      }
+
+      return s;
+   }
+
+   void LinearContext :: release( void* state )
+   // finishes and deletes a thread's state
+   {
+      if( state )
+      {
+         ThreadState* s = (ThreadState*) state;
+         if( s->Y ) cholmod_l_free_dense( &s->Y, &s->common );
+         if( s->E ) cholmod_l_free_dense( &s->E, &s->common );
+         cholmod_l_finish( &s->common );
+         delete s;
+      }
+   }
+
+   int cholmodOrdering( OrderingMethod method )
+   // returns the CHOLMOD constant corresponding to the given method
    {
-      return &context;
+      switch( method )
+      {
+         case orderAMD:              return CHOLMOD_AMD;
+         case orderMETIS:            return CHOLMOD_METIS;
+         case orderNestedDissection: return CHOLMOD_NESDIS;
+         default:                    return CHOLMOD_AMD;
+      }
+   }
+
+   cholmod_factor* LinearContext :: analyze( cholmod_sparse* A )
+   // computes the symbolic Cholesky factorization of the symmetric matrix A,
+   // using a cached fill-reducing ordering if one is available
+   {
+      cholmod_common* common = *this;
+      int nmethods = common->nmethods;
+      int method0 = common->method[0].ordering;
+
+      cholmod_factor* L = NULL;
+      vector<UF_long> perm;
+      if( orderings.find( A, ordering, perm ))
+      {
+         common->nmethods = 1;
+         common->method[0].ordering = CHOLMOD_GIVEN;
+         L = cholmod_l_analyze_p( A, &perm[0], NULL, 0, common );
+
+         if( L == NULL )
+         {
+            // never reuse an ordering that CHOLMOD rejected
+            cerr << "Warning: cached ordering was rejected; computing a new one" << endl;
+            orderings.erase( A, ordering );
+            common->nmethods = nmethods;
+            common->method[0].ordering = method0;
+         }
+      }
+
+      if( L == NULL )
+      {
+         OrderingMethod method = ordering;
+         if( method != orderAuto )
+         {
+            common->nmethods = 1;
+            common->method[0].ordering = cholmodOrdering( method );
+         }
+
+         L = cholmod_l_analyze( A, common );
+
+         if( L == NULL && method != orderAuto )
+         {
+            // METIS may not be available in this build of CHOLMOD
+            cerr << "Warning: requested ordering failed; using default ordering" << endl;
+            common->nmethods = nmethods;
+            common->method[0].ordering = method0;
+            L = cholmod_l_analyze( A, common );
+            method = orderAuto;
+         }
+
+         // store the ordering under the method that actually produced it, so
+         // that a fallback is never mistaken for the requested ordering
+         if( L != NULL )
+         {
+            orderings.insert( A, method, (UF_long*) L->Perm );
+         }
+      }
+
+      common->nmethods = nmethods;
+      common->method[0].ordering = method0;
+
+      return L;
+   }
+
+   void LinearContext :: orderColumns( cholmod_sparse* A, vector<UF_long>& perm )
+   // computes a fill-reducing column ordering for the LU factorization of A
+   {
+      perm.clear();
+
+      if( ordering == orderAuto || A->nrow != A->ncol )
+      {
+         return;
+      }
+
+      if( orderings.find( A, ordering, perm ))
+      {
+         return;
+      }
+
+      // order the symmetrized pattern A+A^T
+      cholmod_common* common = *this;
+      double one[2] = { 1., 0. };
+      cholmod_sparse* AT = cholmod_l_transpose( A, 0, common );
+      cholmod_sparse* S = cholmod_l_add( A, AT, one, one, false, true, common );
+      S->stype = 1;
+
+      OrderingMethod method;
+      if( computeOrdering( S, perm, method ))
+      {
+         orderings.insert( A, method, &perm[0] );
+      }
+      else
+      {
+         perm.clear();
+      }
+
+      cholmod_l_free_sparse( &AT, common );
+      cholmod_l_free_sparse( &S, common );
+   }
+
+   bool LinearContext :: computeOrdering( cholmod_sparse* S, vector<UF_long>& perm, OrderingMethod& method )
+   // orders the symmetric matrix S using the current ordering method, and
+   // stores the method actually used in method; returns false if the
+   // ordering could not be computed
+   {
+      UF_long n = S->ncol;
+      perm.resize( n );
+      method = ordering;
+      if( n == 0 ) return true;
+
+      cholmod_common* common = *this;
+      bool ok = false;
+      if( ordering == orderMETIS )
+      {
+         ok = cholmod_l_metis( S, NULL, 0, true, &perm[0], common );
+      }
+      else if( ordering == orderNestedDissection )
+      {
+         vector<UF_long> cParent( n ), cMember( n );
+         ok = cholmod_l_nested_dissection( S, NULL, 0, &perm[0], &cParent[0], &cMember[0], common ) >= 0;
+      }
+
+      if( !ok )
+      {
+         // AMD is always available (and is the fallback if METIS is not)
+         ok = cholmod_l_amd( S, NULL, 0, &perm[0], common );
+         method = orderAMD;
+      }
+
+      return ok;
    }
 }
@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <cassert>
+using namespace std;
+
+#include "MeshLaplacian.h"
+
+namespace DDG
+{
+   const int meshLaplacianBlockSize = 8192;
+   // number of rows per task when apply() runs on several threads; operators
+   // with fewer rows than this are always applied on the calling thread
+
+   template <class T>
+   MeshLaplacian<T> :: MeshLaplacian( const Mesh& mesh, double shift )
+   // constructs the operator d0^T star1 d0 + shift star0 on the
+   // vertices of mesh
+   : nThreads( 0 )
+   {
+      int nV = mesh.vertices.size();
+
+      // count the neighbors of each vertex
+      offsets.assign( nV+1, 0 );
+      for( EdgeCIter e  = mesh.edges.begin();
+                     e != mesh.edges.end();
+                     e ++ )
+      {
+         offsets[ e->he->vertex->index + 1 ]++;
+         offsets[ e->he->flip->vertex->index + 1 ]++;
+      }
+      for( int i = 0; i < nV; i++ )
+      {
+         offsets[i+1] += offsets[i];
+      }
+
+      // store the cotan weight of each edge with both of its endpoints
+      neighbors.resize( offsets[nV] );
+      weights.resize( offsets[nV] );
+      diagonals.assign( nV, 0. );
+      vector<int> next( offsets.begin(), offsets.end()-1 );
+      for( EdgeCIter e  = mesh.edges.begin();
+                     e != mesh.edges.end();
+                     e ++ )
+      {
+         double w = ( e->he->cotan() + e->he->flip->cotan() ) / 2.;
+         int i = e->he->vertex->index;
+         int j = e->he->flip->vertex->index;
+
+         neighbors[ next[i] ] = j; weights[ next[i] ] = w; next[i]++;
+         neighbors[ next[j] ] = i; weights[ next[j] ] = w; next[j]++;
+         diagonals[i] += w;
+         diagonals[j] += w;
+      }
+
+      if( shift != 0. )
+      {
+         for( VertexCIter v  = mesh.vertices.begin();
+                          v != mesh.vertices.end();
+                          v ++ )
+         {
+            diagonals[ v->index ] += shift * v->area();
+         }
+      }
+   }
+
+   template <class T>
+   int MeshLaplacian<T> :: size( void ) const
+   // returns the number of vertices
+   {
+      return diagonals.size();
+   }
+
+   template <class T>
+   void MeshLaplacian<T> :: setThreads( int nThreads_ )
+   // sets the number of threads used by apply(); zero means one per
+   // processor, one disables threading
+   {
+      nThreads = nThreads_;
+   }
+
+   template <class T>
+   void MeshLaplacian<T> :: apply( const DenseMatrix<T>& x, DenseMatrix<T>& y ) const
+   // computes y = Ax
+   {
+      int n = size();
+
+      assert( x.nRows() == n );
+      assert( &x != &y );
+
+      if( y.nRows() != n || y.nColumns() != x.nColumns() )
+      {
+         y = DenseMatrix<T>( n, x.nColumns() );
+      }
+
+      if( nThreads == 1 || n < 2*meshLaplacianBlockSize )
+      {
+         applyRange( x, y, 0, n );
+         return;
+      }
+
+      vector<ThreadPool::Task*> tasks;
+      for( int begin = 0; begin < n; begin += meshLaplacianBlockSize )
+      {
+         int end = min( n, begin + meshLaplacianBlockSize );
+         tasks.push_back( new Block( *this, x, y, begin, end ));
+      }
+
+      ThreadPool pool( nThreads );
+      pool.run( tasks );
+
+      for( size_t k = 0; k < tasks.size(); k++ )
+      {
+         delete tasks[k];
+      }
+   }
+
+   template <class T>
+   void MeshLaplacian<T> :: applyRange( const DenseMatrix<T>& x, DenseMatrix<T>& y, int begin, int end ) const
+   // computes rows begin through end-1 of y = Ax
+   {
+      const int*    nbr = neighbors.empty() ? NULL : &neighbors[0];
+      const double* w   =   weights.empty() ? NULL : &weights[0];
+
+      for( int c = 0; c < x.nColumns(); c++ )
+      {
+         for( int i = begin; i < end; i++ )
+         {
+            T yi = diagonals[i] * x( i, c );
+            for( int k = offsets[i]; k < offsets[i+1]; k++ )
+            {
+               yi -= w[k] * x( nbr[k], c );
+            }
+            y( i, c ) = yi;
+         }
+      }
+   }
+
+   template <class T>
+   void MeshLaplacian<T> :: diagonal( DenseMatrix<T>& d ) const
+   // stores the diagonal of the operator in the column vector d
+   {
+      int n = size();
+
+      d = DenseMatrix<T>( n );
+      for( int i = 0; i < n; i++ )
+      {
+         d( i ) = diagonals[i];
+      }
+   }
+
+   template <class T>
+   MeshLaplacian<T> :: Block :: Block( const MeshLaplacian<T>& A_, const DenseMatrix<T>& x_, DenseMatrix<T>& y_, int begin_, int end_ )
+   : A( A_ ), x( x_ ), y( y_ ), begin( begin_ ), end( end_ )
+   {}
+
+   template <class T>
+   void MeshLaplacian<T> :: Block :: run( void )
+   {
+      A.applyRange( x, y, begin, end );
+   }
+}
@@ -0,0 +1,257 @@
+#include <algorithm>
+#include <cassert>
+using namespace std;
+
+#include "MulticolorGaussSeidel.h"
+#include "LinearContext.h"
+#include "SolverStats.h"
+
+namespace DDG
+{
+   extern LinearContext context;
+
+   const int multicolorBlockSize = 4096;
+   // number of rows per task when a color class is relaxed on several
+   // threads; smaller classes are relaxed on the calling thread
+
+   template <class T>
+   void relaxRows( const cholmod_sparse* A,
+                   const int* rows, int nRows,
+                   DenseMatrix<T>& x,
+                   const DenseMatrix<T>& b,
+                   double omega )
+   // relaxes the given (mutually uncoupled) rows; since A is Hermitian,
+   // row i of A is the conjugate of the (compressed) column i
+   {
+      const UF_long* Ap = (const UF_long*) A->p;
+      const UF_long* Ai = (const UF_long*) A->i;
+      const T*       Ax = (const T*)       A->x;
+
+      for( int c = 0; c < b.nColumns(); c++ )
+      {
+         for( int k = 0; k < nRows; k++ )
+         {
+            int i = rows[k];
+
+            T sum = b( i, c );
+            T diagonal = 0.;
+            for( UF_long p = Ap[i]; p < Ap[i+1]; p++ )
+            {
+               int j = Ai[p];
+               if( j == i )
+               {
+                  diagonal = Ax[p];
+               }
+               else
+               {
+                  sum -= Ax[p].conj() * x( j, c );
+               }
+            }
+
+            if( omega == 1. )
+            {
+               x( i, c ) = sum / diagonal;
+            }
+            else
+            {
+               x( i, c ) = ( 1. - omega ) * x( i, c ) + omega * ( sum / diagonal );
+            }
+         }
+      }
+   }
+
+   template <class T>
+   class RelaxationTask : public ThreadPool::Task
+   // relaxes a block of rows of the same color
+   {
+      public:
+         RelaxationTask( const cholmod_sparse* A_, const int* rows_, int nRows_,
+                         DenseMatrix<T>& x_, const DenseMatrix<T>& b_, double omega_ )
+         : A( A_ ), rows( rows_ ), nRows( nRows_ ), x( x_ ), b( b_ ), omega( omega_ )
+         {}
+
+         virtual void run( void )
+         {
+            relaxRows( A, rows, nRows, x, b, omega );
+         }
+
+      protected:
+         const cholmod_sparse* A;
+         const int* rows;
+         int nRows;
+         DenseMatrix<T>& x;
+         const DenseMatrix<T>& b;
+         double omega;
+   };
+
+   template <class T>
+   void multicolorSweep( const cholmod_sparse* A,
+                         const GraphColoring& coloring,
+                         DenseMatrix<T>& x,
+                         const DenseMatrix<T>& b,
+                         bool forward,
+                         double omega,
+                         int nThreads )
+   // applies one forward or backward relaxation sweep for Ax = b
+   {
+      assert( coloring.size() == (int) A->ncol );
+
+      int nC = coloring.nColors();
+      for( int k = 0; k < nC; k++ )
+      {
+         int color = forward ? k : nC-1-k;
+         int begin = coloring.offsets[color];
+         int end   = coloring.offsets[color+1];
+         const int* rows = &coloring.members[0];
+
+         if( nThreads == 1 || end - begin < 2*multicolorBlockSize )
+         {
+            relaxRows( A, rows + begin, end - begin, x, b, omega );
+            continue;
+         }
+
+         vector<ThreadPool::Task*> tasks;
+         for( int first = begin; first < end; first += multicolorBlockSize )
+         {
+            int n = min( end - first, multicolorBlockSize );
+            tasks.push_back( new RelaxationTask<T>( A, rows + first, n, x, b, omega ));
+         }
+
+         ThreadPool pool( nThreads );
+         pool.run( tasks );
+
+         for( size_t t = 0; t < tasks.size(); t++ )
+         {
+            delete tasks[t];
+         }
+      }
+   }
+
+   template <class T>
+   MulticolorGaussSeidel<T> :: MulticolorGaussSeidel( void )
+   : omega( 1. ),
+     nThreads( 0 ),
+     maxIterations( 1000 ),
+     tolerance( 1e-10 ),
+     A( NULL )
+   {}
+
+   template <class T>
+   MulticolorGaussSeidel<T> :: ~MulticolorGaussSeidel( void )
+   // destructor
+   {
+      if( A )
+      {
+         cholmod_l_free_sparse( &A, context );
+      }
+   }
+
+   template <class T>
+   void MulticolorGaussSeidel<T> :: build( SparseMatrix<T>& A_ )
+   // stores a copy of A and colors its sparsity pattern
+   {
+      GraphColoring patternColoring;
+      patternColoring.build( A_.to_cholmod() );
+      build( A_, patternColoring );
+   }
+
+   template <class T>
+   void MulticolorGaussSeidel<T> :: build( SparseMatrix<T>& A_, const GraphColoring& coloring_ )
+   // stores a copy of A, whose unknowns are colored by coloring
+   {
+      assert( A_.nRows() == A_.nColumns() );
+      assert( A_.nRows() == coloring_.size() );
+
+      if( A )
+      {
+         cholmod_l_free_sparse( &A, context );
+      }
+
+      A = cholmod_l_copy_sparse( A_.to_cholmod(), context );
+      A->stype = 0;
+      coloring = coloring_;
+   }
+
+   template <class T>
+   void MulticolorGaussSeidel<T> :: sweep( DenseMatrix<T>& x, const DenseMatrix<T>& b, bool forward ) const
+   // applies one forward or backward relaxation sweep for Ax = b
+   {
+      assert( A );
+
+      multicolorSweep( A, coloring, x, b, forward, omega, nThreads );
+   }
+
+   template <class T>
+   double MulticolorGaussSeidel<T> :: residualNorm( const DenseMatrix<T>& x, const DenseMatrix<T>& b ) const
+   // returns |b-Ax|_2
+   {
+      const UF_long* Ap = (const UF_long*) A->p;
+      const UF_long* Ai = (const UF_long*) A->i;
+      const T*       Ax = (const T*)       A->x;
+      int n = A->ncol;
+
+      DenseMatrix<T> r( b );
+      for( int c = 0; c < b.nColumns(); c++ )
+      {
+         for( int j = 0; j < n; j++ )
+         {
+            T xj = x( j, c );
+            for( UF_long p = Ap[j]; p < Ap[j+1]; p++ )
+            {
+               r( Ai[p], c ) -= Ax[p] * xj;
+            }
+         }
+      }
+
+      return r.norm( lTwo );
+   }
+
+   template <class T>
+   int MulticolorGaussSeidel<T> :: solve( DenseMatrix<T>& x, const DenseMatrix<T>& b )
+   // applies symmetric sweeps until the residual drops below tolerance
+   {
+      assert( A );
+      assert( b.nRows() == (int) A->nrow );
+
+      if( &x == &b )
+      {
+         DenseMatrix<T> bCopy( b );
+         return solve( x, bCopy );
+      }
+
+      Timer timer;
+      if( x.nRows() != b.nRows() || x.nColumns() != b.nColumns() )
+      {
+         x = DenseMatrix<T>( b.nRows(), b.nColumns() );
+      }
+
+      double bNorm = b.norm( lTwo );
+      if( bNorm == 0. )
+      {
+         x.zero();
+         return 0;
+      }
+
+      int iter = 0;
+      double relativeResidual = 1.;
+      while( iter < maxIterations )
+      {
+         sweep( x, b, true );
+         sweep( x, b, false );
+         iter++;
+
+         relativeResidual = residualNorm( x, b ) / bNorm;
+         if( relativeResidual < tolerance ) break;
+      }
+
+      SolverStats stats;
+      stats.solver = "gs";
+      timer.stop( stats );
+      stats.nnzA = cholmod_l_nnz( A, context );
+      stats.iterations = iter;
+      stats.residual = relativeResidual;
+      context.report( stats );
+
+      return iter;
+   }
+}